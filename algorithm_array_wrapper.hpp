@@ -0,0 +1,285 @@
+#ifndef FIBB_ALGORITHM_ARRAY_WRAPPER
+#define FIBB_ALGORITHM_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+#include "prefetch_array_wrapper.hpp"
+
+#include <utility>
+
+// Fixed size wrappers of arithmetic elements up to this size are sorted by a sorting network
+#ifndef FIBB_ARRAY_WRAPPER_SORT_NETWORK_LIMIT
+    #define FIBB_ARRAY_WRAPPER_SORT_NETWORK_LIMIT 16
+#endif
+
+namespace fibb
+{
+    namespace detail
+    {
+        template <typename T>
+        inline constexpr bool is_cheap_comparable_v = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+        /* SORTING NETWORKS */
+        // Batcher's odd-even merge sort, which works for any n and needs O(n log^2 n) comparators
+        template <size_t N>
+        struct Sorting_Network
+        {
+            static constexpr size_t count_comparators() noexcept
+            {
+                size_t count = 0;
+                for (size_t p = 1; p < N; p += p)
+                {
+                    for (size_t k = p; k > 0; k /= 2)
+                    {
+                        for (size_t j = k % p; j + k < N; j += k + k)
+                        {
+                            for (size_t i = 0; i < k && i < N - j - k; ++i)
+                            {
+                                if ((j + i) / (p + p) == (j + i + k) / (p + p)) { ++count; }
+                            }
+                        }
+                    }
+                }
+                return count;
+            }
+
+            static constexpr size_t size = count_comparators();
+
+            struct Comparators
+            {
+                size_t first[size > 0 ? size : 1];
+                size_t second[size > 0 ? size : 1];
+            };
+
+            static constexpr Comparators make_comparators() noexcept
+            {
+                Comparators result{};
+                size_t count = 0;
+                for (size_t p = 1; p < N; p += p)
+                {
+                    for (size_t k = p; k > 0; k /= 2)
+                    {
+                        for (size_t j = k % p; j + k < N; j += k + k)
+                        {
+                            for (size_t i = 0; i < k && i < N - j - k; ++i)
+                            {
+                                if ((j + i) / (p + p) == (j + i + k) / (p + p))
+                                {
+                                    result.first[count] = j + i;
+                                    result.second[count] = j + i + k;
+                                    ++count;
+                                }
+                            }
+                        }
+                    }
+                }
+                return result;
+            }
+
+            static constexpr Comparators comparators = make_comparators();
+        };
+
+        // both selects compile to conditional moves or min/max instructions
+        template <typename T, typename Compare>
+        inline void compare_exchange(T& a, T& b, Compare& comp)
+        {
+            const T x = a;
+            const T y = b;
+            const bool swapped = comp(y, x);
+            a = swapped ? y : x;
+            b = swapped ? x : y;
+        }
+
+        template <size_t N, typename T, typename Compare, size_t... I>
+        inline void sort_network(T* a, Compare& comp, std::index_sequence<I...>)
+        {
+            using network = Sorting_Network<N>;
+            static_cast<void>(a); // a single element needs no comparators
+            (compare_exchange(a[network::comparators.first[I]], a[network::comparators.second[I]], comp), ...);
+        }
+
+        /* RADIX SORT */
+        template <typename T>
+        inline constexpr bool is_radix_sortable_v = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+        // the digit of a key in a pass, signed keys have their sign bit flipped so that they order as unsigned
+        template <typename T>
+        inline size_t radix_digit(T key, size_t pass) noexcept
+        {
+            using U = std::make_unsigned_t<T>;
+            constexpr U sign = std::is_signed_v<T> ? U(U(1) << (8 * sizeof(T) - 1)) : U(0);
+            return static_cast<size_t>((static_cast<U>(key) ^ sign) >> (8 * pass)) & 0xFF;
+        }
+    }
+
+    /* SEARCH */
+    // Like std::find, but tests a block of elements without branching before deciding whether the
+    // value is in it, so that the test vectorizes.
+    template <typename T, size_t N>
+    inline T* find(Array_Wrapper<T, N> array_, const std::remove_cv_t<T>& value)
+    {
+        constexpr size_t block = 4 * detail::elements_per_line<T>;
+        T* a = array_.data();
+        const size_t n = array_.size();
+
+        size_t i = 0;
+        if constexpr (detail::is_cheap_comparable_v<std::remove_cv_t<T>>)
+        {
+            for (; i + block <= n; i += block)
+            {
+                unsigned found = 0;
+                for (size_t j = 0; j < block; ++j) { found |= static_cast<unsigned>(a[i + j] == value); }
+                if (found != 0) { break; }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (a[i] == value) { return a + i; }
+        }
+        return a + n;
+    }
+
+    // Like std::lower_bound on a sorted wrapper, but the loop has no data dependent branches: every
+    // step halves the range with a conditional move, so a fixed N has a fixed trip count.
+    template <typename T, size_t N, typename Compare = std::less<>>
+    inline T* lower_bound(Array_Wrapper<T, N> array_, const std::remove_cv_t<T>& value, Compare comp = Compare())
+    {
+        T* base = array_.data();
+        size_t n = array_.size();
+        if (n == 0) { return base; }
+
+        while (n > 1)
+        {
+            const size_t half = n / 2;
+            base = comp(base[half], value) ? base + half : base;
+            n -= half;
+        }
+        return base + static_cast<size_t>(comp(*base, value));
+    }
+
+    template <typename T, size_t N, typename Compare = std::less<>>
+    inline T* upper_bound(Array_Wrapper<T, N> array_, const std::remove_cv_t<T>& value, Compare comp = Compare())
+    {
+        return lower_bound(array_, value, [&comp] (const auto& element, const auto& x) { return !comp(x, element); });
+    }
+
+    template <typename T, size_t N, typename Compare = std::less<>>
+    inline bool binary_search(const Array_Wrapper<T, N>& array_, const std::remove_cv_t<T>& value, Compare comp = Compare())
+    {
+        const T* found = lower_bound(Array_Wrapper<const T, N>(array_), value, comp);
+        return found != array_.end() && !comp(value, *found);
+    }
+
+    /* EYTZINGER LAYOUT */
+    /* The Eytzinger layout stores a sorted array as an implicit binary tree in breadth first order,
+       the children of element k being 2k + 1 and 2k + 2. A search then reads memory front to back,
+       the top levels of the tree share a few hot cache lines, and the nodes a few levels down lie
+       next to each other so they can be prefetched. Lookups in tables larger than the cache are
+       then much faster than a binary search, at the cost of building the layout once. */
+
+    // writes the elements of sorted, which must be sorted, to out in Eytzinger order
+    template <typename T, size_t N, typename U, size_t M>
+    inline void eytzinger_layout(Array_Wrapper<T, N> out, const Array_Wrapper<U, M>& sorted)
+    {
+        if constexpr (N != dynamic_extent && M != dynamic_extent)
+        {
+            static_assert(N == M, "Array_Wrappers must have the same size");
+        }
+        else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(out.size() != sorted.size()))
+        {
+            detail::raise_length_error(out.size(), sorted.size());
+        }
+
+        // an in-order walk of the tree visits the sorted elements in order, k is 1 based
+        const U* in = sorted.data();
+        T* tree = out.data();
+        const size_t n = out.size();
+        size_t next = 0;
+        size_t k = 1;
+        while (next < n)
+        {
+            while (k <= n) { k *= 2; } // leftmost descendant
+            k >>= detail::count_trailing_zeros(~std::uint64_t(k)) + 1; // back up to the first unvisited ancestor
+            tree[k - 1] = in[next++];
+            k = 2 * k + 1; // then its right subtree
+        }
+    }
+
+    // Index in the layout of the first element which is not less than value, or its size if there is none
+    template <typename T, size_t N, typename Compare = std::less<>>
+    inline size_t eytzinger_lower_bound(const Array_Wrapper<T, N>& layout, const std::remove_cv_t<T>& value, Compare comp = Compare())
+    {
+        constexpr size_t line = detail::elements_per_line<T>;
+        const T* tree = layout.data();
+        const size_t n = layout.size();
+
+        size_t k = 1;
+        while (k <= n)
+        {
+            // the descendants log2(line) levels down share a cache line
+            if (line * k <= n) { detail::prefetch(tree + line * k - 1); }
+            k = 2 * k + static_cast<size_t>(comp(tree[k - 1], value));
+        }
+
+        // the last left turn is the answer; none means every element is less than value
+        k >>= detail::count_trailing_zeros(~std::uint64_t(k)) + 1;
+        return k == 0 ? n : k - 1;
+    }
+
+    /* SORT */
+    // Fixed size wrappers of arithmetic elements up to FIBB_ARRAY_WRAPPER_SORT_NETWORK_LIMIT are sorted
+    // by an unrolled sorting network, which has no branches; everything else uses std::sort.
+    template <typename T, size_t N, typename Compare = std::less<>>
+    inline void sort(Array_Wrapper<T, N> array_, Compare comp = Compare())
+    {
+        if constexpr (N != dynamic_extent && N <= FIBB_ARRAY_WRAPPER_SORT_NETWORK_LIMIT
+            && detail::is_cheap_comparable_v<std::remove_cv_t<T>>)
+        {
+            detail::sort_network<N>(array_.data(), comp, std::make_index_sequence<detail::Sorting_Network<N>::size>());
+        }
+        else
+        {
+            std::sort(array_.begin(), array_.end(), comp);
+        }
+    }
+
+    // Sorts integers in ascending order with a stable LSD radix sort on bytes, which is O(n) and beats
+    // std::sort from a few hundred elements on. scratch must hold at least as many elements; taking it
+    // from the caller keeps allocations out of the sort. The digit histograms for every pass are
+    // counted in one read of the keys, and passes where all keys share a digit are skipped.
+    template <typename T, size_t N, typename U, size_t M>
+    inline void radix_sort(Array_Wrapper<T, N> array_, Array_Wrapper<U, M> scratch)
+    {
+        static_assert(std::is_same_v<U, T>, "Scratch must have the same, writable element type");
+        static_assert(detail::is_radix_sortable_v<T>, "Radix sort needs integer elements");
+
+        constexpr size_t passes = sizeof(T);
+        const size_t n = array_.size();
+        if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(scratch.size() < n)) { detail::raise_length_error(n, scratch.size()); }
+        if (n < 2) { return; }
+
+        size_t histogram[passes][256] = {};
+        T* src = array_.data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t pass = 0; pass < passes; ++pass) { ++histogram[pass][detail::radix_digit(src[i], pass)]; }
+        }
+
+        T* dest = scratch.data();
+        for (size_t pass = 0; pass < passes; ++pass)
+        {
+            size_t* counts = histogram[pass];
+            if (counts[detail::radix_digit(src[0], pass)] == n) { continue; } // every key has this digit
+
+            // exclusive prefix sum turns the counts into the first slot of each digit
+            size_t offset = 0;
+            for (size_t digit = 0; digit < 256; ++digit) { offset += std::exchange(counts[digit], offset); }
+
+            for (size_t i = 0; i < n; ++i) { dest[counts[detail::radix_digit(src[i], pass)]++] = src[i]; }
+            std::swap(src, dest);
+        }
+
+        if (src != array_.data()) { std::copy_n(src, n, array_.data()); }
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef FIBB_ALIGNED_ARRAY_WRAPPER
+#define FIBB_ALIGNED_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+namespace fibb
+{
+    /* The Aligned_Array_Wrapper is an Array_Wrapper whose array is known to start on an Alignment
+       byte boundary, e.g. one declared alignas(64). data(), begin(), end() and operator[] hand out
+       pointers the compiler may assume to be aligned, so auto-vectorized loops over them can use
+       aligned loads and stores and skip the peeling prologue. fill() does the same internally.
+
+       The alignment is checked on construction through the usual check policy, except in constant
+       expressions where an address can't be inspected. Sub-views and conversions to Array_Wrapper
+       drop the alignment since an offset generally breaks it. */
+
+    template <typename T, size_t N, size_t Alignment>
+    class Aligned_Array_Wrapper : public Array_Wrapper<T, N>
+    {
+        private:
+            using base_type = Array_Wrapper<T, N>;
+
+            static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+            static_assert(Alignment >= alignof(T), "Alignment can't be weaker than the element type's");
+
+        public:
+            /* TYPES */
+            using typename base_type::value_type;
+            using typename base_type::pointer;
+            using typename base_type::const_pointer;
+            using typename base_type::reference;
+            using typename base_type::const_reference;
+            using typename base_type::size_type;
+            using typename base_type::iterator;
+            using typename base_type::const_iterator;
+
+            static constexpr size_type alignment = Alignment;
+
+            /* CONSTRUCTORS */
+            template <size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Aligned_Array_Wrapper(T (&array_)[M]) // sized array
+                : base_type(array_)
+            {
+                checked_pointer(array_);
+            }
+
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Aligned_Array_Wrapper(T*& array_) // decayed array pointer
+                : base_type(array_)
+            {
+                checked_pointer(array_);
+            }
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Aligned_Array_Wrapper(pointer array_, size_type size_) // pointer and runtime size
+                : base_type(checked_pointer(array_), size_)
+            {}
+
+            // adopting a plain wrapper has to check its alignment so it is explicit
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr explicit Aligned_Array_Wrapper(const base_type& other)
+                : base_type(other)
+            {
+                checked_pointer(other.data());
+            }
+
+            constexpr Aligned_Array_Wrapper(const Aligned_Array_Wrapper&) = default;
+
+            /* ASSIGNMENT */
+            // copies elements like Array_Wrapper, the implicit copy assignment forwards to it
+            using base_type::operator=;
+
+            void fill(const_reference val)
+            {
+                // the memset and streaming paths are alignment agnostic, an element loop is the one which profits
+                if constexpr (detail::is_bitwise_copy_assignable_v<value_type>)
+                {
+                    unsigned char byte;
+                    if (detail::use_streaming_stores(this->size() * sizeof(T)) || detail::is_byte_pattern(val, byte))
+                    {
+                        base_type::fill(val);
+                        return;
+                    }
+                }
+                std::fill_n(data(), this->size(), val);
+            }
+
+            /* ITERATORS */
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr iterator begin() noexcept { return data(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator begin() const noexcept { return data(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator cbegin() const noexcept { return data(); }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr iterator end() noexcept { return data() + this->size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator end() const noexcept { return data() + this->size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator cend() const noexcept { return data() + this->size(); }
+
+            /* ELEMENT ACCESS */
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr reference operator[](size_type pos) noexcept
+            {
+                detail::check_access(pos, this->size());
+                return data()[pos];
+            }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_reference operator[](size_type pos) const noexcept
+            {
+                detail::check_access(pos, this->size());
+                return data()[pos];
+            }
+
+            // the alignment hint is skipped in constant expressions, see detail::assume_aligned
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr pointer data() noexcept { return detail::assume_aligned<Alignment>(base_type::data()); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_pointer data() const noexcept { return detail::assume_aligned<Alignment>(base_type::data()); }
+
+        private:
+            template <typename U>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE static constexpr U* checked_pointer(U* array_)
+            {
+                if (detail::is_constant_evaluated()) { return array_; }
+
+                const auto address = reinterpret_cast<std::uintptr_t>(array_);
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(address % Alignment != 0))
+                {
+                    detail::raise_invalid_argument("Misaligned array: ", address);
+                }
+                return array_;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef FIBB_ARENA_ARRAY_WRAPPER
+#define FIBB_ARENA_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <memory>
+#include <new>
+#include <vector>
+
+// Size of the blocks an Arena allocates from the heap, requests larger than this get a block of their own
+#ifndef FIBB_ARRAY_WRAPPER_ARENA_BLOCK
+    #define FIBB_ARRAY_WRAPPER_ARENA_BLOCK (size_t(64) * 1024)
+#endif
+
+namespace fibb
+{
+    /* An Arena owns storage for arrays which all die together, e.g. the buffers of one request. make()
+       bump allocates aligned storage from large blocks and returns it wrapped, and reset() gives all of
+       it back at once while keeping the blocks for the next round, so a warmed up arena doesn't call
+       malloc at all. Arrays made in a row are contiguous as long as they fit in the block.
+
+           fibb::Arena arena;
+           auto samples = arena.make<float, 1024>();
+           auto indices = arena.make<std::uint32_t>(count, 0);
+           ...
+           arena.reset();
+
+       Elements are default initialized, so trivial types start out indeterminate like a new T[N], and
+       they must be trivially destructible since nothing is destroyed. The arena is move only. */
+
+    class Arena
+    {
+        public:
+            /* TYPES */
+            using size_type = size_t;
+
+            /* CONSTRUCTORS */
+            // every array is aligned to at least alignment_ bytes, which must be a power of two up to a cache line
+            explicit Arena(size_type block_size_ = FIBB_ARRAY_WRAPPER_ARENA_BLOCK, size_type alignment_ = alignof(std::max_align_t))
+                : m_block_size(block_size_), m_alignment(alignment_)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(m_alignment == 0 || (m_alignment & (m_alignment - 1)) != 0
+                    || m_alignment > block_alignment))
+                {
+                    detail::raise_invalid_argument("Invalid arena alignment: ", m_alignment);
+                }
+            }
+
+            Arena(Arena&&) noexcept = default;
+            Arena& operator=(Arena&&) noexcept = default;
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            /* ARRAYS */
+            template <typename T, size_t N>
+            Array_Wrapper<T, N> make()
+            {
+                static_assert(N != dynamic_extent, "Use make<T>(count) for a runtime size");
+                T* first = construct<T>(N);
+                return Array_Wrapper<T, N>(first);
+            }
+
+            template <typename T, size_t N>
+            Array_Wrapper<T, N> make(const T& val)
+            {
+                Array_Wrapper<T, N> result = make<T, N>();
+                result.fill(val);
+                return result;
+            }
+
+            template <typename T>
+            Array_Wrapper<T, dynamic_extent> make(size_type count)
+            {
+                return Array_Wrapper<T, dynamic_extent>(construct<T>(count), count);
+            }
+
+            template <typename T>
+            Array_Wrapper<T, dynamic_extent> make(size_type count, const T& val)
+            {
+                Array_Wrapper<T, dynamic_extent> result = make<T>(count);
+                result.fill(val);
+                return result;
+            }
+
+            /* STORAGE */
+            // raw storage, alignment must be a power of two up to a cache line
+            void* allocate(size_type bytes, size_type alignment_)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(alignment_ == 0 || (alignment_ & (alignment_ - 1)) != 0
+                    || alignment_ > block_alignment))
+                {
+                    detail::raise_invalid_argument("Invalid alignment: ", alignment_);
+                }
+
+                for (; m_current < m_blocks.size(); ++m_current, m_offset = 0)
+                {
+                    const size_type offset = (m_offset + alignment_ - 1) & ~(alignment_ - 1);
+                    if (offset <= m_blocks[m_current].size && bytes <= m_blocks[m_current].size - offset)
+                    {
+                        m_offset = offset + bytes;
+                        return m_blocks[m_current].data.get() + offset;
+                    }
+                }
+
+                // blocks start on a cache line so the first allocation in one needs no padding
+                m_blocks.push_back(Block{std::max(m_block_size, bytes)});
+                m_current = m_blocks.size() - 1;
+                m_offset = bytes;
+                return m_blocks.back().data.get();
+            }
+
+            // everything made so far is given back, the blocks are kept for reuse
+            void reset() noexcept
+            {
+                m_current = 0;
+                m_offset = 0;
+            }
+
+            // everything made so far is given back and the blocks are freed
+            void release() noexcept
+            {
+                m_blocks.clear();
+                reset();
+            }
+
+            /* CAPACITY */
+            // bytes held in blocks, used or not
+            size_type capacity() const noexcept
+            {
+                size_type result = 0;
+                for (const Block& block : m_blocks) { result += block.size; }
+                return result;
+            }
+
+        private:
+            static constexpr size_type block_alignment = FIBB_ARRAY_WRAPPER_CACHE_LINE;
+
+            struct Block_Deleter
+            {
+                void operator()(unsigned char* data) const noexcept
+                {
+                    ::operator delete(data, std::align_val_t(block_alignment));
+                }
+            };
+
+            struct Block
+            {
+                explicit Block(size_type size_)
+                    : data(static_cast<unsigned char*>(::operator new(size_, std::align_val_t(block_alignment)))), size(size_)
+                {}
+
+                std::unique_ptr<unsigned char[], Block_Deleter> data;
+                size_type size;
+            };
+
+            std::vector<Block> m_blocks;
+            size_type m_current = 0; // block allocations are made from
+            size_type m_offset = 0;  // first unused byte in it
+            size_type m_block_size;
+            size_type m_alignment;
+
+            template <typename T>
+            T* construct(size_type count)
+            {
+                static_assert(std::is_trivially_destructible_v<T>, "Arena elements are never destroyed");
+                static_assert(alignof(T) <= block_alignment, "Arena elements can't be over-aligned beyond a cache line");
+
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(count > std::numeric_limits<size_type>::max() / sizeof(T)))
+                {
+                    detail::raise_length_error(std::numeric_limits<size_type>::max() / sizeof(T), count);
+                }
+
+                T* first = static_cast<T*>(allocate(count * sizeof(T), std::max(alignof(T), m_alignment)));
+                std::uninitialized_default_construct_n(first, count);
+                return first;
+            }
+    };
+
+    /* A Slab_Pool recycles arrays of one size class, so that buffers with independent lifetimes can be
+       handed back one at a time. Slots are Slot_Size bytes with the given alignment, and an array of
+       any N elements of T that fits can be acquired from them. Slots are carved from slabs of an
+       internal Arena and kept on an intrusive free list, so acquire() and release() are a few loads and
+       stores. reset() returns every slot in one go. As in the Arena, elements are default initialized,
+       must be trivially destructible, and an acquired array must only be released to the pool it came
+       from. Slab_Pool_For<T, N> is the pool sized for exactly Array_Wrapper<T, N>. */
+
+    template <size_t Slot_Size, size_t Alignment = alignof(std::max_align_t)>
+    class Slab_Pool
+    {
+        private:
+            struct Free_Slot
+            {
+                Free_Slot* next;
+            };
+
+        public:
+            /* TYPES */
+            using size_type = size_t;
+
+            static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+            static_assert(Alignment <= FIBB_ARRAY_WRAPPER_CACHE_LINE, "Slots can't be over-aligned beyond a cache line");
+
+            // slots hold the free list link when unused and are padded to keep the next one aligned
+            static constexpr size_type alignment = std::max(Alignment, alignof(Free_Slot));
+            static constexpr size_type slot_size = (std::max(Slot_Size, sizeof(Free_Slot)) + alignment - 1) & ~(alignment - 1);
+
+            /* CONSTRUCTORS */
+            explicit Slab_Pool(size_type slots_per_slab_ = 64)
+                : m_arena(slot_size * slots_per_slab_, alignment), m_slots_per_slab(slots_per_slab_)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(m_slots_per_slab == 0))
+                {
+                    detail::raise_invalid_argument("Invalid slots per slab: ", m_slots_per_slab);
+                }
+            }
+
+            Slab_Pool(Slab_Pool&& other) noexcept
+                : m_arena(std::move(other.m_arena)), m_free(std::exchange(other.m_free, nullptr)),
+                m_slots_per_slab(other.m_slots_per_slab)
+            {}
+
+            Slab_Pool& operator=(Slab_Pool&& other) noexcept
+            {
+                m_arena = std::move(other.m_arena);
+                m_free = std::exchange(other.m_free, nullptr);
+                m_slots_per_slab = other.m_slots_per_slab;
+                return *this;
+            }
+
+            /* ARRAYS */
+            template <typename T, size_t N>
+            Array_Wrapper<T, N> acquire()
+            {
+                static_assert(N != dynamic_extent && N * sizeof(T) <= Slot_Size, "Array doesn't fit in a slot");
+                static_assert(alignof(T) <= alignment, "Array is more strictly aligned than a slot");
+                static_assert(std::is_trivially_destructible_v<T>, "Pool elements are never destroyed");
+
+                if (m_free == nullptr) { refill(); }
+                Free_Slot* slot = m_free;
+                m_free = slot->next;
+
+                T* first = reinterpret_cast<T*>(slot);
+                std::uninitialized_default_construct_n(first, N);
+                return Array_Wrapper<T, N>(first);
+            }
+
+            template <typename T, size_t N>
+            void release(Array_Wrapper<T, N> array_) noexcept
+            {
+                static_assert(N != dynamic_extent && N * sizeof(T) <= Slot_Size, "Array doesn't fit in a slot");
+                m_free = ::new (static_cast<void*>(array_.data())) Free_Slot{m_free};
+            }
+
+            // every slot is free again, the slabs are kept
+            void reset() noexcept
+            {
+                m_arena.reset();
+                m_free = nullptr;
+            }
+
+        private:
+            Arena m_arena;
+            Free_Slot* m_free = nullptr;
+            size_type m_slots_per_slab;
+
+            // threads a new slab onto the free list so that its slots are handed out in address order
+            void refill()
+            {
+                auto* slab = static_cast<unsigned char*>(m_arena.allocate(slot_size * m_slots_per_slab, alignment));
+                for (size_type i = m_slots_per_slab; i-- > 0;)
+                {
+                    m_free = ::new (static_cast<void*>(slab + i * slot_size)) Free_Slot{m_free};
+                }
+            }
+    };
+
+    template <typename T, size_t N>
+    using Slab_Pool_For = Slab_Pool<N * sizeof(T), std::max(alignof(T), alignof(std::max_align_t))>;
+}
+
+#endif
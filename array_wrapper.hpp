@@ -6,9 +6,902 @@
 #include <algorithm>
 #include <stdexcept>
 #include <array>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <immintrin.h>
+    #define FIBB_ARRAY_WRAPPER_X86_SIMD
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define FIBB_ARRAY_WRAPPER_NEON_SIMD
+#endif
+
+// Marks what can also be called in CUDA and HIP device code: construction, element access, iterators and
+// sub-views. In device code check failures trap, since there are neither exceptions nor std::string,
+// and the sampled access policy and the instrumentation are off.
+#if defined(__CUDACC__) || defined(__HIPCC__)
+    #define FIBB_ARRAY_WRAPPER_HOST_DEVICE __host__ __device__
+#else
+    #define FIBB_ARRAY_WRAPPER_HOST_DEVICE
+#endif
+
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+    #define FIBB_ARRAY_WRAPPER_DEVICE_CODE
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+    #include <compare>
+#endif
+
+#if defined(__cpp_lib_three_way_comparison) && __cpp_lib_three_way_comparison >= 201907L
+    #define FIBB_ARRAY_WRAPPER_THREE_WAY
+#endif
+
+// Bulk copies and fills of trivially copyable elements which are at least this many bytes use
+// non-temporal stores so that they do not evict the rest of the cache. Define as 0 to disable.
+#ifndef FIBB_ARRAY_WRAPPER_STREAMING_THRESHOLD
+    #define FIBB_ARRAY_WRAPPER_STREAMING_THRESHOLD (size_t(1) << 21)
+#endif
+
+// Layouts and work splits that must not share a cache line between threads are aligned to this many bytes
+#ifndef FIBB_ARRAY_WRAPPER_CACHE_LINE
+    #define FIBB_ARRAY_WRAPPER_CACHE_LINE 64
+#endif
+
+// Fixed size wrappers up to this many elements compare, fill, copy and swap with straight-line code
+// generated from an index sequence instead of a loop or a library call. Define as 0 to disable.
+#ifndef FIBB_ARRAY_WRAPPER_UNROLL_LIMIT
+    #define FIBB_ARRAY_WRAPPER_UNROLL_LIMIT 16
+#endif
+
+// What at(), the runtime sized sub-views and assignments between dynamic wrappers of different sizes do
+// when their check fails: throw the usual std exception, call std::abort(), execute a trap instruction or
+// skip the check altogether. The abort and trap policies also work with exceptions disabled.
+#define FIBB_ARRAY_WRAPPER_CHECK_THROW 0
+#define FIBB_ARRAY_WRAPPER_CHECK_ABORT 1
+#define FIBB_ARRAY_WRAPPER_CHECK_TRAP 2
+#define FIBB_ARRAY_WRAPPER_CHECK_UNCHECKED 3
+
+#ifndef FIBB_ARRAY_WRAPPER_CHECK
+    #define FIBB_ARRAY_WRAPPER_CHECK FIBB_ARRAY_WRAPPER_CHECK_THROW
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define FIBB_ARRAY_WRAPPER_COLD __attribute__((cold, noinline))
+    #define FIBB_ARRAY_WRAPPER_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#elif defined(_MSC_VER)
+    #define FIBB_ARRAY_WRAPPER_COLD __declspec(noinline)
+    #define FIBB_ARRAY_WRAPPER_UNLIKELY(x) (x)
+#else
+    #define FIBB_ARRAY_WRAPPER_COLD
+    #define FIBB_ARRAY_WRAPPER_UNLIKELY(x) (x)
+#endif
+
+// true if a check is enabled and cond holds, the failure branch is laid out away from the hot path
+#define FIBB_ARRAY_WRAPPER_CHECK_FAILED(cond) \
+    (FIBB_ARRAY_WRAPPER_CHECK != FIBB_ARRAY_WRAPPER_CHECK_UNCHECKED && FIBB_ARRAY_WRAPPER_UNLIKELY(cond))
+
+// How operator[], front() and back() check their index. Unchecked is the usual behaviour. Checked validates
+// every access and aborts or traps through the check failure path, even with the throw policy because these
+// functions are noexcept. Sampled validates one access in every FIBB_ARRAY_WRAPPER_ACCESS_SAMPLE_RATE per thread
+// and only counts the violations it finds, see fibb::access_violations().
+#define FIBB_ARRAY_WRAPPER_ACCESS_UNCHECKED 0
+#define FIBB_ARRAY_WRAPPER_ACCESS_CHECKED 1
+#define FIBB_ARRAY_WRAPPER_ACCESS_SAMPLED 2
+
+#ifndef FIBB_ARRAY_WRAPPER_ACCESS
+    #define FIBB_ARRAY_WRAPPER_ACCESS FIBB_ARRAY_WRAPPER_ACCESS_UNCHECKED
+#endif
+
+#ifndef FIBB_ARRAY_WRAPPER_ACCESS_SAMPLE_RATE
+    #define FIBB_ARRAY_WRAPPER_ACCESS_SAMPLE_RATE 1024
+#endif
+
+// Define as 1 to count the calls and bytes of every assignment, fill, swap, comparison and at() failure,
+// see fibb::operation_count(). Counts are kept per thread and added to the global totals every
+// FIBB_ARRAY_WRAPPER_INSTRUMENT_FLUSH operations and when the thread exits. With a hook installed by
+// fibb::set_trace_hook(), one operation in every FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE per thread is also
+// timed and reported to it. When disabled, the default, the hooks compile to nothing.
+#ifndef FIBB_ARRAY_WRAPPER_INSTRUMENT
+    #define FIBB_ARRAY_WRAPPER_INSTRUMENT 0
+#endif
+
+#ifndef FIBB_ARRAY_WRAPPER_INSTRUMENT_FLUSH
+    #define FIBB_ARRAY_WRAPPER_INSTRUMENT_FLUSH 4096
+#endif
+
+#ifndef FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE
+    #define FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE 1024
+#endif
+
+#if FIBB_ARRAY_WRAPPER_INSTRUMENT
+    #include <chrono>
+#endif
 
 namespace fibb
 {
+    inline constexpr size_t dynamic_extent = std::numeric_limits<size_t>::max();
+
+    /* INSTRUMENTATION */
+    // The operations counted by FIBB_ARRAY_WRAPPER_INSTRUMENT. Assign covers the copy, move and expression
+    // assignments, Compare covers == and the ordering operators, the others are evident.
+    enum class Wrapper_Operation { Assign, Fill, Swap, Compare, At_Failure };
+
+    inline constexpr size_t wrapper_operation_count = 5;
+
+    // Totals for one operation, bytes are those of the destination, or of either side of a swap or comparison
+    struct Operation_Count
+    {
+        std::uint64_t calls;
+        std::uint64_t bytes;
+    };
+
+    // A timed operation on the wrapped array at data, times are steady clock nanoseconds. This has all a
+    // complete event of ITT or Perfetto needs.
+    struct Trace_Event
+    {
+        Wrapper_Operation operation;
+        const void* data;
+        size_t bytes;
+        std::uint64_t start;
+        std::uint64_t duration;
+    };
+
+    // called on the thread which did the operation, so it must be thread safe
+    using Trace_Hook = void (*)(const Trace_Event&);
+
+    namespace detail
+    {
+        // Array_Wrapper derives from this so that a fixed extent costs no storage
+        template <size_t N>
+        class Extent
+        {
+            public:
+                FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr explicit Extent(size_t) noexcept {}
+                FIBB_ARRAY_WRAPPER_HOST_DEVICE static constexpr size_t size() noexcept { return N; }
+        };
+
+        template <>
+        class Extent<dynamic_extent>
+        {
+            public:
+                FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr explicit Extent(size_t size_) noexcept : m_size(size_) {}
+                FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr size_t size() const noexcept { return m_size; }
+
+            private:
+                size_t m_size;
+        };
+
+        /* Bulk kernels used by Array_Wrapper when the element type can be copied as raw bytes.
+           memcpy/memset/memmove are only valid for trivially copyable types and the assignment
+           operators additionally require the relevant assignment to be trivial so that a bytewise
+           copy is exactly what the element assignment would have done. */
+
+        template <typename T>
+        inline constexpr bool is_bitwise_copy_assignable_v = std::is_trivially_copyable_v<T>
+            && std::is_trivially_copy_assignable_v<T> && !std::is_volatile_v<T>;
+
+        template <typename T>
+        inline constexpr bool is_bitwise_move_assignable_v = std::is_trivially_copyable_v<T>
+            && std::is_trivially_move_assignable_v<T> && !std::is_volatile_v<T>;
+
+        template <typename T>
+        inline constexpr bool is_bitwise_swappable_v = is_bitwise_move_assignable_v<T>
+            && std::is_trivially_move_constructible_v<T>;
+
+        // lets the kernels fall back to plain loops during constant evaluation, where memcpy,
+        // intrinsics and most of <algorithm> (before C++20) are unavailable
+        FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr bool is_constant_evaluated() noexcept
+        {
+#if defined(__cpp_lib_is_constant_evaluated) && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+            return __builtin_is_constant_evaluated();
+#else
+            return false;
+#endif
+        }
+
+        /* CHECK FAILURES */
+        // Out of line and cold so that a check costs each call site a compare and a branch, instead of
+        // inlining the message formatting everywhere.
+        [[noreturn]] FIBB_ARRAY_WRAPPER_COLD FIBB_ARRAY_WRAPPER_HOST_DEVICE inline void check_failed() noexcept
+        {
+#if defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE) && defined(__CUDA_ARCH__)
+            __trap();
+#elif defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            __builtin_trap();
+#elif FIBB_ARRAY_WRAPPER_CHECK == FIBB_ARRAY_WRAPPER_CHECK_TRAP && (defined(__GNUC__) || defined(__clang__))
+            __builtin_trap();
+#elif FIBB_ARRAY_WRAPPER_CHECK == FIBB_ARRAY_WRAPPER_CHECK_TRAP && defined(_MSC_VER)
+            __fastfail(7); // FAST_FAIL_FATAL_APP_EXIT
+#else
+            std::abort();
+#endif
+        }
+
+        [[noreturn]] FIBB_ARRAY_WRAPPER_COLD FIBB_ARRAY_WRAPPER_HOST_DEVICE inline void raise_range_error(size_t pos)
+        {
+#if FIBB_ARRAY_WRAPPER_CHECK == FIBB_ARRAY_WRAPPER_CHECK_THROW && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            throw std::out_of_range(std::string("Out of range: ") + std::to_string(pos));
+#else
+            static_cast<void>(pos);
+            check_failed();
+#endif
+        }
+
+        [[noreturn]] FIBB_ARRAY_WRAPPER_COLD FIBB_ARRAY_WRAPPER_HOST_DEVICE inline void raise_length_error(size_t size, size_t other_size)
+        {
+#if FIBB_ARRAY_WRAPPER_CHECK == FIBB_ARRAY_WRAPPER_CHECK_THROW && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            throw std::length_error(std::string("Size mismatch: ") + std::to_string(size)
+                + " and " + std::to_string(other_size));
+#else
+            static_cast<void>(size);
+            static_cast<void>(other_size);
+            check_failed();
+#endif
+        }
+
+        [[noreturn]] FIBB_ARRAY_WRAPPER_COLD FIBB_ARRAY_WRAPPER_HOST_DEVICE inline void raise_invalid_argument(const char* what, size_t value)
+        {
+#if FIBB_ARRAY_WRAPPER_CHECK == FIBB_ARRAY_WRAPPER_CHECK_THROW && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            throw std::invalid_argument(std::string(what) + std::to_string(value));
+#else
+            static_cast<void>(what);
+            static_cast<void>(value);
+            check_failed();
+#endif
+        }
+
+        /* ACCESS CHECKS */
+        inline std::atomic<std::uint64_t> access_violation_count{0};
+
+        FIBB_ARRAY_WRAPPER_COLD inline void record_access_violation() noexcept
+        {
+            access_violation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void sample_access(size_t pos, size_t size) noexcept
+        {
+            static_assert(FIBB_ARRAY_WRAPPER_ACCESS_SAMPLE_RATE > 0);
+
+            // per thread so that sampling does not add contention on a shared counter
+            thread_local std::uint32_t countdown = FIBB_ARRAY_WRAPPER_ACCESS_SAMPLE_RATE;
+            if (FIBB_ARRAY_WRAPPER_UNLIKELY(--countdown == 0))
+            {
+                countdown = FIBB_ARRAY_WRAPPER_ACCESS_SAMPLE_RATE;
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(pos >= size)) { record_access_violation(); }
+            }
+        }
+
+        FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr void check_access(size_t pos, size_t size) noexcept
+        {
+#if FIBB_ARRAY_WRAPPER_ACCESS == FIBB_ARRAY_WRAPPER_ACCESS_CHECKED
+            if (FIBB_ARRAY_WRAPPER_UNLIKELY(pos >= size)) { check_failed(); }
+#elif FIBB_ARRAY_WRAPPER_ACCESS == FIBB_ARRAY_WRAPPER_ACCESS_SAMPLED && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            if (!is_constant_evaluated()) { sample_access(pos, size); }
+#else
+            static_cast<void>(pos);
+            static_cast<void>(size);
+#endif
+        }
+
+        /* INSTRUMENTATION */
+        struct Operation_Totals
+        {
+            std::atomic<std::uint64_t> calls[wrapper_operation_count];
+            std::atomic<std::uint64_t> bytes[wrapper_operation_count];
+        };
+
+        inline Operation_Totals operation_totals{};
+        inline std::atomic<Trace_Hook> trace_hook{nullptr};
+
+#if FIBB_ARRAY_WRAPPER_INSTRUMENT
+        // plain counters, so that counting doesn't add contention on the shared totals
+        struct Thread_Operation_Counts
+        {
+            std::uint64_t calls[wrapper_operation_count] = {};
+            std::uint64_t bytes[wrapper_operation_count] = {};
+            std::uint32_t flush_countdown = FIBB_ARRAY_WRAPPER_INSTRUMENT_FLUSH;
+            std::uint32_t trace_countdown = FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE;
+
+            void flush() noexcept
+            {
+                for (size_t i = 0; i < wrapper_operation_count; ++i)
+                {
+                    if (calls[i] == 0) { continue; }
+                    operation_totals.calls[i].fetch_add(std::exchange(calls[i], 0), std::memory_order_relaxed);
+                    operation_totals.bytes[i].fetch_add(std::exchange(bytes[i], 0), std::memory_order_relaxed);
+                }
+                flush_countdown = FIBB_ARRAY_WRAPPER_INSTRUMENT_FLUSH;
+            }
+
+            ~Thread_Operation_Counts() { flush(); }
+        };
+
+        inline Thread_Operation_Counts& thread_operation_counts() noexcept
+        {
+            thread_local Thread_Operation_Counts counts;
+            return counts;
+        }
+
+        inline std::uint64_t trace_clock() noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // what end_operation() needs to time an operation, start is 0 when it isn't sampled
+        struct Operation_Trace
+        {
+            Wrapper_Operation operation;
+            const void* data;
+            size_t bytes;
+            std::uint64_t start;
+        };
+
+        inline Operation_Trace record_operation(Wrapper_Operation operation, const void* data, size_t bytes) noexcept
+        {
+            static_assert(FIBB_ARRAY_WRAPPER_INSTRUMENT_FLUSH > 0 && FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE > 0);
+
+            Thread_Operation_Counts& counts = thread_operation_counts();
+            const auto i = static_cast<size_t>(operation);
+            ++counts.calls[i];
+            counts.bytes[i] += bytes;
+            if (FIBB_ARRAY_WRAPPER_UNLIKELY(--counts.flush_countdown == 0)) { counts.flush(); }
+
+            Operation_Trace trace{operation, data, bytes, 0};
+            if (FIBB_ARRAY_WRAPPER_UNLIKELY(--counts.trace_countdown == 0))
+            {
+                counts.trace_countdown = FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE;
+                if (trace_hook.load(std::memory_order_relaxed) != nullptr) { trace.start = trace_clock(); }
+            }
+            return trace;
+        }
+
+        FIBB_ARRAY_WRAPPER_COLD inline void report_trace(const Operation_Trace& trace) noexcept
+        {
+            const std::uint64_t end = trace_clock();
+            if (Trace_Hook hook = trace_hook.load(std::memory_order_relaxed))
+            {
+                hook(Trace_Event{trace.operation, trace.data, trace.bytes, trace.start, end - trace.start});
+            }
+        }
+#else
+        struct Operation_Trace {};
+#endif
+
+        // An operation calls begin_operation() on entry and end_operation() with its result on exit.
+        // Nothing is recorded during constant evaluation.
+        FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Operation_Trace begin_operation(Wrapper_Operation operation, const void* data, size_t bytes) noexcept
+        {
+#if FIBB_ARRAY_WRAPPER_INSTRUMENT && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            if (!is_constant_evaluated()) { return record_operation(operation, data, bytes); }
+            return Operation_Trace{operation, data, bytes, 0};
+#else
+            static_cast<void>(operation);
+            static_cast<void>(data);
+            static_cast<void>(bytes);
+            return Operation_Trace{};
+#endif
+        }
+
+        FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr void end_operation(const Operation_Trace& trace) noexcept
+        {
+#if FIBB_ARRAY_WRAPPER_INSTRUMENT && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            if (FIBB_ARRAY_WRAPPER_UNLIKELY(trace.start != 0)) { report_trace(trace); }
+#else
+            static_cast<void>(trace);
+#endif
+        }
+
+        // tells the optimiser that ptr is a multiple of Alignment so that loops need no peeling
+        template <size_t Alignment, typename T>
+        FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr T* assume_aligned(T* ptr) noexcept
+        {
+            if (is_constant_evaluated()) { return ptr; }
+#if defined(__cpp_lib_assume_aligned) && !defined(FIBB_ARRAY_WRAPPER_DEVICE_CODE)
+            return std::assume_aligned<Alignment>(ptr);
+#elif defined(__GNUC__) || defined(__clang__)
+            return static_cast<T*>(__builtin_assume_aligned(ptr, Alignment));
+#else
+            return ptr;
+#endif
+        }
+
+        constexpr bool use_streaming_stores(size_t bytes) noexcept
+        {
+            return FIBB_ARRAY_WRAPPER_STREAMING_THRESHOLD != 0 && bytes >= FIBB_ARRAY_WRAPPER_STREAMING_THRESHOLD;
+        }
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+    #if defined(__AVX512F__)
+        using stream_vector = __m512i;
+        inline stream_vector stream_load(const unsigned char* src) noexcept { return _mm512_loadu_si512(src); }
+        inline void stream_store(unsigned char* dest, stream_vector v) noexcept
+        {
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dest), v);
+        }
+    #elif defined(__AVX__)
+        using stream_vector = __m256i;
+        inline stream_vector stream_load(const unsigned char* src) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        }
+        inline void stream_store(unsigned char* dest, stream_vector v) noexcept
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dest), v);
+        }
+    #else
+        using stream_vector = __m128i;
+        inline stream_vector stream_load(const unsigned char* src) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        }
+        inline void stream_store(unsigned char* dest, stream_vector v) noexcept
+        {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dest), v);
+        }
+    #endif
+        inline constexpr size_t stream_width = sizeof(stream_vector);
+
+        // bytes needed to advance ptr to the next stream_width boundary
+        inline size_t stream_head(const void* ptr) noexcept
+        {
+            return (stream_width - reinterpret_cast<std::uintptr_t>(ptr) % stream_width) % stream_width;
+        }
+#endif
+
+        // Copy between non-overlapping regions bypassing the cache where the target supports it
+        inline void stream_copy(void* dest_, const void* src_, size_t bytes) noexcept
+        {
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+            auto* dest = static_cast<unsigned char*>(dest_);
+            auto* src = static_cast<const unsigned char*>(src_);
+
+            // non-temporal stores must be aligned so the head is copied normally
+            const size_t head = std::min(stream_head(dest), bytes);
+            std::memcpy(dest, src, head);
+            dest += head;
+            src += head;
+            bytes -= head;
+
+            for (; bytes >= stream_width; dest += stream_width, src += stream_width, bytes -= stream_width)
+            {
+                stream_store(dest, stream_load(src));
+            }
+            _mm_sfence(); // non-temporal stores are weakly ordered
+
+            std::memcpy(dest, src, bytes);
+#else
+            std::memcpy(dest_, src_, bytes);
+#endif
+        }
+
+        // Fill count elements bypassing the cache where the target supports it
+        template <typename T>
+        inline void stream_fill(T* dest, size_t count, const T& val) noexcept
+        {
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+            // a vector can only be built from whole elements and only reaches alignment
+            // at an element boundary if the array itself is element size aligned
+            if constexpr (stream_width % sizeof(T) == 0)
+            {
+                if (reinterpret_cast<std::uintptr_t>(dest) % sizeof(T) == 0)
+                {
+                    const size_t head = std::min(stream_head(dest) / sizeof(T), count);
+                    dest = std::fill_n(dest, head, val);
+                    count -= head;
+
+                    alignas(stream_vector) unsigned char pattern[stream_width];
+                    for (size_t i = 0; i < stream_width; i += sizeof(T)) { std::memcpy(pattern + i, &val, sizeof(T)); }
+                    const stream_vector v = stream_load(pattern);
+
+                    constexpr size_t per_vector = stream_width / sizeof(T);
+                    for (; count >= per_vector; dest += per_vector, count -= per_vector)
+                    {
+                        stream_store(reinterpret_cast<unsigned char*>(dest), v);
+                    }
+                    _mm_sfence();
+                }
+            }
+#endif
+            std::fill_n(dest, count, val);
+        }
+
+        // memset can be used when every byte of the value is identical, e.g. zero
+        template <typename T>
+        inline bool is_byte_pattern(const T& val, unsigned char& byte) noexcept
+        {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &val, sizeof(T));
+            byte = bytes[0];
+            return std::all_of(bytes + 1, bytes + sizeof(T), [byte] (unsigned char b) { return b == byte; });
+        }
+
+        template <typename T>
+        inline void bitwise_fill(T* dest, size_t count, const T& val) noexcept
+        {
+            unsigned char byte;
+            if (is_byte_pattern(val, byte)) { std::memset(dest, byte, count * sizeof(T)); }
+            else { std::fill_n(dest, count, val); }
+        }
+
+        // Swap the contents of two non-overlapping regions in register sized blocks
+        inline void swap_bytes(void* a_, void* b_, size_t bytes) noexcept
+        {
+            auto* a = static_cast<unsigned char*>(a_);
+            auto* b = static_cast<unsigned char*>(b_);
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+    #if defined(__AVX512F__)
+            for (; bytes >= 64; a += 64, b += 64, bytes -= 64)
+            {
+                const __m512i va = _mm512_loadu_si512(a);
+                const __m512i vb = _mm512_loadu_si512(b);
+                _mm512_storeu_si512(a, vb);
+                _mm512_storeu_si512(b, va);
+            }
+    #endif
+    #if defined(__AVX__)
+            for (; bytes >= 32; a += 32, b += 32, bytes -= 32)
+            {
+                const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+                const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(a), vb);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(b), va);
+            }
+    #endif
+            for (; bytes >= 16; a += 16, b += 16, bytes -= 16)
+            {
+                const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(a), vb);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(b), va);
+            }
+#elif defined(FIBB_ARRAY_WRAPPER_NEON_SIMD)
+            for (; bytes >= 32; a += 32, b += 32, bytes -= 32)
+            {
+                const uint8x16x2_t va = vld1q_u8_x2(a);
+                const uint8x16x2_t vb = vld1q_u8_x2(b);
+                vst1q_u8_x2(a, vb);
+                vst1q_u8_x2(b, va);
+            }
+            for (; bytes >= 16; a += 16, b += 16, bytes -= 16)
+            {
+                const uint8x16_t va = vld1q_u8(a);
+                const uint8x16_t vb = vld1q_u8(b);
+                vst1q_u8(a, vb);
+                vst1q_u8(b, va);
+            }
+#endif
+            // remainder, or everything when there is no SIMD support
+            unsigned char tmp[64];
+            while (bytes > 0)
+            {
+                const size_t block = std::min(bytes, sizeof(tmp));
+                std::memcpy(tmp, a, block);
+                std::memcpy(a, b, block);
+                std::memcpy(b, tmp, block);
+                a += block;
+                b += block;
+                bytes -= block;
+            }
+        }
+
+        /* Comparison kernels. Integers, enums and pointers compare equal exactly when their bytes do
+           so they can be compared as raw memory. Floating point can't (-0.0 == 0.0, NaN != NaN) but
+           can still be compared a vector at a time with the usual IEEE semantics. */
+
+        template <typename T>
+        inline constexpr bool is_bitwise_comparable_v = (std::is_integral_v<T> || std::is_enum_v<T>
+            || std::is_pointer_v<T>) && !std::is_volatile_v<T>;
+
+        template <typename T>
+        inline constexpr bool is_simd_comparable_v = is_bitwise_comparable_v<T>
+            || std::is_same_v<T, const float> || std::is_same_v<T, const double>;
+
+        // x must be non-zero
+        inline unsigned count_trailing_zeros(std::uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index;
+            _BitScanForward64(&index, x);
+            return static_cast<unsigned>(index);
+#else
+            unsigned count = 0;
+            for (; (x & 1) == 0; x >>= 1) { ++count; }
+            return count;
+#endif
+        }
+
+        // index of the first differing byte, or bytes if there is none
+        inline size_t mismatch_bytes(const unsigned char* a, const unsigned char* b, size_t bytes) noexcept
+        {
+            size_t i = 0;
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+    #if defined(__AVX512BW__)
+            for (; i + 64 <= bytes; i += 64)
+            {
+                const __mmask64 diff = _mm512_cmpneq_epu8_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+    #endif
+    #if defined(__AVX2__)
+            for (; i + 32 <= bytes; i += 32)
+            {
+                const __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+                const std::uint32_t diff = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+    #endif
+            for (; i + 16 <= bytes; i += 16)
+            {
+                const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                const std::uint32_t diff = ~static_cast<std::uint32_t>(_mm_movemask_epi8(eq)) & 0xFFFF;
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+#elif defined(FIBB_ARRAY_WRAPPER_NEON_SIMD)
+            for (; i + 16 <= bytes; i += 16)
+            {
+                // narrowing shift packs the byte mask into 4 bits per byte
+                const uint8x16_t eq = vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+                const std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+                if (mask != ~std::uint64_t(0)) { return i + count_trailing_zeros(~mask) / 4; }
+            }
+#endif
+            // a word at a time, the byte loop below then finds the exact position
+            for (; i + 8 <= bytes; i += 8)
+            {
+                std::uint64_t wa, wb;
+                std::memcpy(&wa, a + i, 8);
+                std::memcpy(&wb, b + i, 8);
+                if (wa != wb) { break; }
+            }
+            for (; i < bytes; ++i)
+            {
+                if (a[i] != b[i]) { return i; }
+            }
+            return bytes;
+        }
+
+        // index of the first element where !(a[i] == b[i]), or n if there is none
+        inline size_t mismatch_floats(const float* a, const float* b, size_t n) noexcept
+        {
+            size_t i = 0;
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+    #if defined(__AVX__)
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256 eq = _mm256_cmp_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), _CMP_EQ_OQ);
+                const std::uint32_t diff = ~static_cast<std::uint32_t>(_mm256_movemask_ps(eq)) & 0xFF;
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+    #endif
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 eq = _mm_cmpeq_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+                const std::uint32_t diff = ~static_cast<std::uint32_t>(_mm_movemask_ps(eq)) & 0xF;
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+#elif defined(FIBB_ARRAY_WRAPPER_NEON_SIMD) && defined(__aarch64__)
+            for (; i + 4 <= n; i += 4)
+            {
+                if (vminvq_u32(vceqq_f32(vld1q_f32(a + i), vld1q_f32(b + i))) == 0) { break; }
+            }
+#endif
+            for (; i < n; ++i)
+            {
+                if (!(a[i] == b[i])) { return i; }
+            }
+            return n;
+        }
+
+        inline size_t mismatch_floats(const double* a, const double* b, size_t n) noexcept
+        {
+            size_t i = 0;
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD)
+    #if defined(__AVX__)
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m256d eq = _mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_EQ_OQ);
+                const std::uint32_t diff = ~static_cast<std::uint32_t>(_mm256_movemask_pd(eq)) & 0xF;
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+    #endif
+            for (; i + 2 <= n; i += 2)
+            {
+                const __m128d eq = _mm_cmpeq_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+                const std::uint32_t diff = ~static_cast<std::uint32_t>(_mm_movemask_pd(eq)) & 0x3;
+                if (diff != 0) { return i + count_trailing_zeros(diff); }
+            }
+#elif defined(FIBB_ARRAY_WRAPPER_NEON_SIMD) && defined(__aarch64__)
+            for (; i + 2 <= n; i += 2)
+            {
+                const uint64x2_t eq = vceqq_f64(vld1q_f64(a + i), vld1q_f64(b + i));
+                if (vminvq_u32(vreinterpretq_u32_u64(eq)) == 0) { break; }
+            }
+#endif
+            for (; i < n; ++i)
+            {
+                if (!(a[i] == b[i])) { return i; }
+            }
+            return n;
+        }
+
+        // T is the const qualified element type
+        template <typename T>
+        inline size_t mismatch_index(T* a, T* b, size_t n) noexcept
+        {
+            static_assert(is_simd_comparable_v<T>);
+
+            if constexpr (is_bitwise_comparable_v<T>)
+            {
+                return mismatch_bytes(reinterpret_cast<const unsigned char*>(a),
+                    reinterpret_cast<const unsigned char*>(b), n * sizeof(T)) / sizeof(T);
+            }
+            else
+            {
+                return mismatch_floats(a, b, n);
+            }
+        }
+
+        template <typename T>
+        constexpr bool equal_elements(const T* a, const T* b, size_t n)
+        {
+            if (is_constant_evaluated())
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (!(a[i] == b[i])) { return false; }
+                }
+                return true;
+            }
+
+            if constexpr (is_bitwise_comparable_v<const T>) { return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0; }
+            else if constexpr (is_simd_comparable_v<const T>) { return mismatch_index(a, b, n) == n; }
+            else { return std::equal(a, a + n, b); }
+        }
+
+        // lexicographical compare which skips the common prefix a vector at a time
+        template <typename T>
+        constexpr bool less_elements(const T* a, size_t a_size, const T* b, size_t b_size)
+        {
+            const size_t n = std::min(a_size, b_size);
+            size_t i = 0;
+
+            if (!is_constant_evaluated())
+            {
+                if constexpr (std::is_same_v<std::remove_cv_t<T>, unsigned char>)
+                {
+                    // memcmp already orders by unsigned bytes
+                    const int order = n == 0 ? 0 : std::memcmp(a, b, n);
+                    if (order != 0) { return order < 0; }
+                    i = n;
+                }
+                else if constexpr (is_simd_comparable_v<const T>)
+                {
+                    // unordered floating point values are equivalent to std::lexicographical_compare so carry on past them
+                    for (i = mismatch_index(a, b, n); i < n; i += 1 + mismatch_index(a + i + 1, b + i + 1, n - i - 1))
+                    {
+                        if (a[i] < b[i]) { return true; }
+                        if (b[i] < a[i]) { return false; }
+                    }
+                }
+            }
+
+            for (; i < n; ++i)
+            {
+                if (a[i] < b[i]) { return true; }
+                if (b[i] < a[i]) { return false; }
+            }
+            return a_size < b_size;
+        }
+
+#if defined(FIBB_ARRAY_WRAPPER_THREE_WAY)
+        // <=> where the element type has it, otherwise a weak ordering built from <, as for std::array
+        struct synth_three_way
+        {
+            template <typename T>
+            constexpr auto operator()(const T& a, const T& b) const
+            {
+                if constexpr (std::three_way_comparable<T>)
+                {
+                    return a <=> b;
+                }
+                else
+                {
+                    if (a < b) { return std::weak_ordering::less; }
+                    if (b < a) { return std::weak_ordering::greater; }
+                    return std::weak_ordering::equivalent;
+                }
+            }
+        };
+
+        template <typename T>
+        using synth_three_way_result_t = decltype(synth_three_way()(std::declval<const T&>(), std::declval<const T&>()));
+
+        // single pass, only the first mismatching element is ever ordered
+        template <typename T>
+        constexpr synth_three_way_result_t<T> three_way_elements(const T* a, size_t a_size, const T* b, size_t b_size)
+        {
+            const size_t n = std::min(a_size, b_size);
+            size_t i = 0;
+
+            if (!is_constant_evaluated())
+            {
+                if constexpr (std::is_same_v<std::remove_cv_t<T>, unsigned char>)
+                {
+                    const int order = n == 0 ? 0 : std::memcmp(a, b, n);
+                    if (order != 0) { return order <=> 0; }
+                    i = n;
+                }
+                else if constexpr (is_simd_comparable_v<const T>)
+                {
+                    // the loop below then orders the mismatching element, if any
+                    i = mismatch_index(a, b, n);
+                }
+            }
+
+            for (; i < n; ++i)
+            {
+                const auto order = synth_three_way()(a[i], b[i]);
+                if (order != 0) { return order; }
+            }
+            return a_size <=> b_size;
+        }
+#endif
+    }
+
+    // Out of bounds accesses found so far by the sampled access policy, across all threads.
+    inline std::uint64_t access_violations() noexcept
+    {
+        return detail::access_violation_count.load(std::memory_order_relaxed);
+    }
+
+    // Totals for an operation across all threads. The calling thread's counts are flushed first, other
+    // threads' are included once they have flushed theirs. Always zero unless FIBB_ARRAY_WRAPPER_INSTRUMENT is set.
+    inline Operation_Count operation_count(Wrapper_Operation operation_) noexcept
+    {
+#if FIBB_ARRAY_WRAPPER_INSTRUMENT
+        detail::thread_operation_counts().flush();
+#endif
+        const auto i = static_cast<size_t>(operation_);
+        return Operation_Count{detail::operation_totals.calls[i].load(std::memory_order_relaxed),
+            detail::operation_totals.bytes[i].load(std::memory_order_relaxed)};
+    }
+
+    // Installs the hook which sampled operations are reported to, nullptr stops the sampling. Returns
+    // the previous hook.
+    inline Trace_Hook set_trace_hook(Trace_Hook hook_) noexcept
+    {
+        return detail::trace_hook.exchange(hook_, std::memory_order_relaxed);
+    }
+
+    // true for the lazy element-wise expressions of expression_array_wrapper.hpp, which can be assigned to a wrapper
+    template <typename E>
+    struct is_array_expression : std::false_type {};
+
     /* The Array_Wrapper is intended to wrap a raw C array so that it can be passed to a template
        expecting a std::array. All methods are designed to give the same functionality as those
        of std::array.
@@ -17,11 +910,23 @@ namespace fibb
        exist for the lifetime of the Array_Wrapper.
 
        Although std::array supports a size of zero as a special case, zero sized raw arrays are illegal
-       in C++, therefore passing a zero sized raw array to Array_Wrapper is undefined behaviour. */
+       in C++, therefore passing a zero sized raw array to Array_Wrapper is undefined behaviour.
+
+       When N is dynamic_extent the size is only known at runtime and is stored alongside the pointer,
+       much like std::span. Any fixed size wrapper converts implicitly to the dynamic one. Copying,
+       moving or swapping elements between dynamic wrappers of different sizes throws std::length_error. */
 
     template <typename T, size_t N>
-    class Array_Wrapper
+    class Array_Wrapper : private detail::Extent<N>
     {
+        private:
+            using extent_type = detail::Extent<N>;
+
+            // std::array<T, dynamic_extent> can't be instantiated so the dynamic wrapper replaces it with
+            // a type nothing converts to, std::array arguments go through the converting constructor instead
+            class No_Std_Array { No_Std_Array(); };
+            using std_array_type = std::conditional_t<N == dynamic_extent, No_Std_Array, std::array<T, N>>;
+
         public:
             /* TYPES */
             using value_type = T;
@@ -36,130 +941,256 @@ namespace fibb
             using reverse_iterator = std::reverse_iterator<iterator>;
             using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+            static constexpr size_type extent = N;
+
             /* CONSTRUCTORS */
-            Array_Wrapper(T (&array_)[N]) // sized array
-                : m_array(array_)
+            template <size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(T (&array_)[M]) // sized array
+                : extent_type(M), m_array(array_)
             {
-                static_assert(N > 0);
+                static_assert(M > 0);
             }
 
-            Array_Wrapper(T*& array_) // decayed array pointer, size must be known at compile time
-                : m_array(array_)
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(T*& array_) // decayed array pointer, size must be known at compile time
+                : extent_type(N), m_array(array_)
             {
                 static_assert(N > 0);
             }
 
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper() noexcept // empty dynamic wrapper
+                : extent_type(0), m_array(nullptr)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(pointer array_, size_type size_) noexcept // decayed array pointer with a runtime size
+                : extent_type(size_), m_array(array_)
+            {}
+
+            // any wrapper, including a fixed size one, converts to a dynamic wrapper over the same elements
+            // like std::array a const wrapper only gives const access so it only converts to a const dynamic wrapper
+            template <typename U, size_t M, std::enable_if_t<N == dynamic_extent
+                && std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(Array_Wrapper<U, M>& other) noexcept
+                : extent_type(other.size()), m_array(other.data())
+            {}
+
+            template <typename U, size_t M, std::enable_if_t<N == dynamic_extent
+                && std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(Array_Wrapper<U, M>&& other) noexcept
+                : extent_type(other.size()), m_array(other.data())
+            {}
+
+            template <typename U, size_t M, std::enable_if_t<N == dynamic_extent
+                && std::is_convertible_v<const U(*)[], T(*)[]>, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(const Array_Wrapper<U, M>& other) noexcept
+                : extent_type(other.size()), m_array(other.data())
+            {}
+
+            // a fixed size wrapper also converts to a read only wrapper of the same size
+            template <typename U, size_t M = N, std::enable_if_t<M != dynamic_extent
+                && std::is_same_v<const U, T> && !std::is_same_v<U, T>, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper(const Array_Wrapper<U, N>& other) noexcept
+                : extent_type(N), m_array(other.data())
+            {}
+
+            template <typename U, size_t M, std::enable_if_t<N == dynamic_extent
+                && std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+            constexpr Array_Wrapper(std::array<U, M>& array_) noexcept
+                : extent_type(M), m_array(array_.data())
+            {}
+
+            // copying a wrapper copies the pointer, assigning one copies the elements
+            constexpr Array_Wrapper(const Array_Wrapper&) = default;
+
             /* COMPARISON */
+            // Integers, enums, pointers, float and double are compared a vector at a time,
+            // everything else element by element
             constexpr bool operator==(const Array_Wrapper& other) const noexcept
             {
-                return std::equal(begin(), end(), other.begin());
+                const auto trace = detail::begin_operation(Wrapper_Operation::Compare, m_array, size_bytes());
+                bool result = false;
+                if constexpr (is_unrolled) { result = equal_unrolled(other.m_array, unrolled_indices()); }
+                else { result = size() == other.size() && detail::equal_elements(data(), other.data(), size()); }
+                detail::end_operation(trace);
+                return result;
             }
 
             constexpr bool operator!=(const Array_Wrapper& other) const noexcept { return !(*this == other); }
 
-            constexpr bool operator<(const Array_Wrapper& other) const noexcept
-            {
-                return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
-            }
-
-            constexpr bool operator>(const Array_Wrapper& other) const noexcept
+#if defined(FIBB_ARRAY_WRAPPER_THREE_WAY)
+            // the relational operators are rewritten in terms of <=> so each is a single mismatch scan
+            // the result is the comparison category of T, or std::weak_ordering if T only has <
+            constexpr auto operator<=>(const Array_Wrapper& other) const noexcept
             {
-                auto comp = [] (const_reference a, const_reference b) -> bool { return a > b; };
-                return std::lexicographical_compare(begin(), end(), other.begin(), other.end(), comp);
+                const auto trace = detail::begin_operation(Wrapper_Operation::Compare, m_array, size_bytes());
+                const auto result = detail::three_way_elements(data(), size(), other.data(), other.size());
+                detail::end_operation(trace);
+                return result;
             }
-
-            constexpr bool operator<=(const Array_Wrapper& other) const noexcept
+#else
+            constexpr bool operator<(const Array_Wrapper& other) const noexcept
             {
-                auto comp = [] (const_reference a, const_reference b) -> bool { return a <= b; };
-                return std::lexicographical_compare(begin(), end(), other.begin(), other.end(), comp);
+                const auto trace = detail::begin_operation(Wrapper_Operation::Compare, m_array, size_bytes());
+                const bool result = detail::less_elements(data(), size(), other.data(), other.size());
+                detail::end_operation(trace);
+                return result;
             }
 
-            constexpr bool operator>=(const Array_Wrapper& other) const noexcept
-            {
-                auto comp = [] (const_reference a, const_reference b) -> bool { return a >= b; };
-                return std::lexicographical_compare(begin(), end(), other.begin(), other.end(), comp);
-            }
+            // the remaining operators are defined in terms of < as they are for std::array
+            constexpr bool operator>(const Array_Wrapper& other) const noexcept { return other < *this; }
+            constexpr bool operator<=(const Array_Wrapper& other) const noexcept { return !(other < *this); }
+            constexpr bool operator>=(const Array_Wrapper& other) const noexcept { return !(*this < other); }
+#endif
 
             /* ASSIGNMENT */
+            // Aliasing is decided by pointer identity rather than by comparing elements.
+            // Wrappers over partially overlapping regions of the same array are copied as if by memmove.
+
             // copy assignment will copy elements into the underlying array
             constexpr Array_Wrapper& operator=(const Array_Wrapper& other)
-                noexcept(std::is_nothrow_copy_assignable_v<value_type>)
+                noexcept(std::is_nothrow_copy_assignable_v<value_type> && N != dynamic_extent)
+            {
+                check_same_size(other.size());
+                if (m_array != other.m_array)
+                {
+                    copy_elements(other.m_array, m_array);
+                }
+                return *this;
+            }
+
+            // copy assignment from a wrapper of another size or a read only wrapper over the same elements
+            template <typename U, size_t M, std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T> && !std::is_const_v<T>
+                && (M == N || M == dynamic_extent || N == dynamic_extent), int> = 0>
+            constexpr Array_Wrapper& operator=(const Array_Wrapper<U, M>& other)
             {
-                if (*this != other)
+                if constexpr (N == dynamic_extent || M == dynamic_extent)
+                {
+                    if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(other.size() != size())) { detail::raise_length_error(size(), other.size()); }
+                }
+                if (m_array != other.data())
                 {
-                    std::copy(other.begin(), other.end(), begin());
+                    copy_elements(other.data(), m_array);
                 }
                 return *this;
             }
 
             // copy assignment will copy elements into the underlying array
-            constexpr Array_Wrapper& operator=(const std::array<value_type, N>& other)
+            constexpr Array_Wrapper& operator=(const std_array_type& other)
                 noexcept(std::is_nothrow_copy_assignable_v<value_type>)
             {
                 if (m_array != other.data())
                 {
                     // Iterators for std::array are implementation defined
                     // The data() method always returns a raw ptr
-                    std::copy(other.data(), other.data() + other.size(), begin());
+                    copy_elements(other.data(), m_array);
                 }
                 return *this;
             }
 
-            // move assignment will move elements into the underlying array
-            constexpr Array_Wrapper& operator=(Array_Wrapper&& other)
-                noexcept(std::is_nothrow_move_assignable_v<value_type>)
+            // Move assignment will move elements into the underlying array. It only binds to wrapper rvalues,
+            // so that a raw array, std::array or fixed size wrapper lvalue converted to this wrapper type
+            // is copied by the copy assignment rather than moved from through the temporary.
+            template <typename U, size_t M, std::enable_if_t<std::is_same_v<U, T>
+                && (M == N || M == dynamic_extent || N == dynamic_extent), int> = 0>
+            constexpr Array_Wrapper& operator=(Array_Wrapper<U, M>&& other)
+                noexcept(std::is_nothrow_move_assignable_v<value_type> && N != dynamic_extent && M != dynamic_extent)
             {
-                if (*this != other)
+                if constexpr (N == dynamic_extent || M == dynamic_extent)
                 {
-                    std::move(other.begin(), other.end(), begin());
+                    if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(other.size() != size())) { detail::raise_length_error(size(), other.size()); }
+                }
+                if (m_array != other.data())
+                {
+                    move_elements(other.data(), m_array);
                 }
                 return *this;
             }
 
             // move assignment will move elements into the underlying array
-            constexpr Array_Wrapper& operator=(std::array<value_type, N>&& other)
+            constexpr Array_Wrapper& operator=(std_array_type&& other)
                 noexcept(std::is_nothrow_move_assignable_v<value_type>)
             {
                 if (m_array != other.data())
                 {
                     // Iterators for std::array are implementation defined
                     // The data() method always returns a raw ptr
-                    std::move(other.data(), other.data() + other.size(), begin());
+                    move_elements(other.data(), m_array);
                 }
                 return *this;
             }
 
-            void fill(const_reference val) { std::fill_n(begin(), N, val); }
+            // evaluates the expression in a single pass, operands may be this wrapper itself but not
+            // views which partially overlap it
+            template <typename Expression, std::enable_if_t<is_array_expression<Expression>::value, int> = 0>
+            constexpr Array_Wrapper& operator=(const Expression& expression)
+            {
+                static_assert(N == dynamic_extent || Expression::extent == dynamic_extent || Expression::extent == N);
+
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(expression.size() != size()))
+                {
+                    detail::raise_length_error(size(), expression.size());
+                }
+                const auto trace = detail::begin_operation(Wrapper_Operation::Assign, m_array, size_bytes());
+                for (size_type i = 0; i < size(); ++i) { m_array[i] = expression[i]; }
+                detail::end_operation(trace);
+                return *this;
+            }
+
+            constexpr void fill(const_reference val)
+            {
+                const auto trace = detail::begin_operation(Wrapper_Operation::Fill, m_array, size_bytes());
+                if constexpr (is_unrolled)
+                {
+                    fill_unrolled(val, unrolled_indices());
+                }
+                else if (detail::is_constant_evaluated())
+                {
+                    for (size_type i = 0; i < size(); ++i) { m_array[i] = val; }
+                }
+                else if constexpr (detail::is_bitwise_copy_assignable_v<value_type>)
+                {
+                    if (use_streaming_stores()) { detail::stream_fill(m_array, size(), val); }
+                    else { detail::bitwise_fill(m_array, size(), val); }
+                }
+                else
+                {
+                    std::fill_n(begin(), size(), val);
+                }
+                detail::end_operation(trace);
+            }
 
             // Note that swap will not switch the internal pointers
             // Array_Wrapper will behave as if it were std::array so swap actually swaps elements of the internal array
-            void swap(Array_Wrapper& other) noexcept(std::is_nothrow_swappable_v<value_type>)
+            // Swapping a wrapper with itself is a no-op, swapping partially overlapping wrappers is undefined
+            constexpr void swap(Array_Wrapper& other) noexcept(std::is_nothrow_swappable_v<value_type> && N != dynamic_extent)
             {
-                if (*this != other)
+                check_same_size(other.size());
+                if (m_array != other.m_array)
                 {
-                    std::swap_ranges(begin(), end(), other.begin());
+                    swap_elements(m_array, other.m_array);
                 }
             }
 
-            void swap(std::array<value_type, N>& other) noexcept(std::is_nothrow_swappable_v<value_type>)
+            constexpr void swap(std_array_type& other) noexcept(std::is_nothrow_swappable_v<value_type>)
             {
                 if (m_array != other.data())
                 {
-                    // Swap ranges expects 3 iterators of the same type
                     // Iterators for std::array are implementation defined
                     // The data() method always returns a raw ptr
-                    std::swap_ranges(begin(), end(), other.data());
+                    swap_elements(m_array, other.data());
                 }
             }
 
             /* ITERATORS */
-            constexpr iterator begin() noexcept { return m_array; }
-            constexpr const_iterator begin() const noexcept { return m_array; }
-            constexpr const_iterator cbegin() const noexcept { return m_array; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr iterator begin() noexcept { return m_array; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator begin() const noexcept { return m_array; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator cbegin() const noexcept { return m_array; }
 
-            constexpr iterator end() noexcept { return m_array + N; }
-            constexpr const_iterator end() const noexcept { return m_array + N; }
-            constexpr const_iterator cend() const noexcept { return m_array + N; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr iterator end() noexcept { return m_array + size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator end() const noexcept { return m_array + size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_iterator cend() const noexcept { return m_array + size(); }
 
             constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
             constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
@@ -170,46 +1201,473 @@ namespace fibb
             constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
 
             /* CAPACITY */
-            constexpr size_type size() const noexcept { return N; }
-            constexpr size_type max_size() const noexcept { return N; }
-            constexpr bool empty() const noexcept { return N == 0; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr size_type size() const noexcept { return extent_type::size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr size_type max_size() const noexcept { return size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr bool empty() const noexcept { return size() == 0; }
 
             /* ELEMENT ACCESS */
-            constexpr reference operator[](size_type pos) noexcept { return m_array[pos]; }
-            constexpr const_reference operator[](size_type pos) const noexcept { return m_array[pos]; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr reference operator[](size_type pos) noexcept
+            {
+                detail::check_access(pos, size());
+                return m_array[pos];
+            }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_reference operator[](size_type pos) const noexcept
+            {
+                detail::check_access(pos, size());
+                return m_array[pos];
+            }
 
-            constexpr reference at(size_type pos)
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr reference at(size_type pos)
             {
                 const Array_Wrapper& const_this = *this;
                 return const_cast<reference>(const_this.at(pos));
             }
 
-            constexpr const_reference at(size_type pos) const
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_reference at(size_type pos) const
             {
                 static_assert(std::is_unsigned_v<size_type>);
 
-                if (pos >= N) { raise_range_error(pos); }
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size()))
+                {
+                    const auto trace = detail::begin_operation(Wrapper_Operation::At_Failure, m_array, 0);
+                    detail::end_operation(trace);
+                    detail::raise_range_error(pos);
+                }
 
                 return m_array[pos];
             }
 
-            constexpr reference front() noexcept { return m_array[0]; }
-            constexpr const_reference front() const noexcept { return m_array[0]; }
-            constexpr reference back() noexcept { return m_array[N - 1]; }
-            constexpr const_reference back() const noexcept { return m_array[N - 1]; }
-            constexpr pointer data() noexcept { return m_array; }
-            constexpr const_pointer data() const noexcept { return m_array; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr reference front() noexcept { return (*this)[0]; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_reference front() const noexcept { return (*this)[0]; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr reference back() noexcept { return (*this)[size() - 1]; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_reference back() const noexcept { return (*this)[size() - 1]; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr pointer data() noexcept { return m_array; }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr const_pointer data() const noexcept { return m_array; }
+
+            /* SUB-VIEWS */
+            // Sub-views refer to the same underlying array and never copy elements.
+            // For a fixed size wrapper subview() is bounds checked at compile time, the default Count
+            // takes every element from Offset to the end. The runtime sized versions always return a
+            // dynamic wrapper and throw std::out_of_range if the range does not fit.
+            template <size_t Offset, size_t Count = dynamic_extent>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr auto subview() { return subview_of<Offset, Count>(m_array); }
+
+            template <size_t Offset, size_t Count = dynamic_extent>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr auto subview() const { return subview_of<Offset, Count>(const_pointer(m_array)); }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<T, dynamic_extent> first(size_type count) { return subspan(0, count); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<const T, dynamic_extent> first(size_type count) const { return subspan(0, count); }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<T, dynamic_extent> last(size_type count)
+            {
+                check_range(0, count);
+                return subspan(size() - count, count);
+            }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<const T, dynamic_extent> last(size_type count) const
+            {
+                check_range(0, count);
+                return subspan(size() - count, count);
+            }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<T, dynamic_extent> subspan(size_type offset, size_type count = dynamic_extent)
+            {
+                return subspan_of(m_array, offset, count);
+            }
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<const T, dynamic_extent> subspan(size_type offset, size_type count = dynamic_extent) const
+            {
+                return subspan_of(const_pointer(m_array), offset, count);
+            }
 
         private:
             pointer m_array;
 
-            // ideally this would go into a separate cpp file to prevent inlining
-            constexpr void raise_range_error(size_type pos) const
+            // U is T or const T depending on the constness of the calling method
+            template <size_t Offset, size_t Count, typename U>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr auto subview_of(U* array_) const
+            {
+                constexpr size_t view_extent = Count != dynamic_extent ? Count
+                    : N != dynamic_extent ? N - Offset : dynamic_extent;
+
+                if constexpr (N != dynamic_extent)
+                {
+                    static_assert(Offset < N && view_extent <= N - Offset);
+                }
+                else
+                {
+                    check_range(Offset, Count != dynamic_extent ? Count : 0);
+                }
+
+                U* first_ = array_ + Offset;
+                if constexpr (view_extent == dynamic_extent)
+                {
+                    return Array_Wrapper<U, dynamic_extent>(first_, size() - Offset);
+                }
+                else
+                {
+                    return Array_Wrapper<U, view_extent>(first_);
+                }
+            }
+
+            template <typename U>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Array_Wrapper<U, dynamic_extent> subspan_of(U* array_, size_type offset, size_type count) const
+            {
+                if (count == dynamic_extent)
+                {
+                    check_range(offset, 0);
+                    count = size() - offset;
+                }
+                check_range(offset, count);
+                return Array_Wrapper<U, dynamic_extent>(array_ + offset, count);
+            }
+
+            // written so that offset + count can't overflow
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr void check_range(size_type offset, size_type count) const
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(offset > size())) { detail::raise_range_error(offset); }
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(count > size() - offset)) { detail::raise_range_error(offset + count); }
+            }
+
+            // true if dest lies inside (src, src + size()), in which case a forward copy would overwrite
+            // source elements before they are read
+            // std::less gives a total order even for pointers into unrelated arrays
+            constexpr bool overlaps_forward(const_pointer src, const_pointer dest) const noexcept
+            {
+                return std::less<const_pointer>()(src, dest) && std::less<const_pointer>()(dest, src + size());
+            }
+
+            constexpr bool overlaps(const_pointer a, const_pointer b) const noexcept
+            {
+                return overlaps_forward(a, b) || overlaps_forward(b, a) || a == b;
+            }
+
+            // for a fixed extent this folds to a constant
+            constexpr bool use_streaming_stores() const noexcept
+            {
+                return detail::use_streaming_stores(size() * sizeof(value_type));
+            }
+
+            // pointers into unrelated arrays can't be ordered during constant evaluation but can be tested for equality
+            constexpr bool constant_overlaps_forward(const_pointer src, const_pointer dest) const noexcept
+            {
+                for (size_type i = 1; i < size(); ++i)
+                {
+                    if (src + i == dest) { return true; }
+                }
+                return false;
+            }
+
+            /* UNROLLED SMALL WRAPPERS */
+            // Copies and swaps go through a temporary, which is only cheap for small bitwise copyable types,
+            // so other types keep using the loops.
+            static constexpr bool is_unrolled = N != dynamic_extent && N > 0 && N <= FIBB_ARRAY_WRAPPER_UNROLL_LIMIT;
+            static constexpr bool is_copy_unrolled = is_unrolled && detail::is_bitwise_copy_assignable_v<value_type>
+                && std::is_copy_constructible_v<value_type> && N * sizeof(value_type) <= 256;
+            static constexpr bool is_swap_unrolled = is_copy_unrolled && detail::is_bitwise_swappable_v<value_type>;
+
+            static constexpr auto unrolled_indices() noexcept { return std::make_index_sequence<is_unrolled ? N : 0>(); }
+
+            // scalars are compared without short circuiting so that the result needs no branches
+            template <size_t... I>
+            constexpr bool equal_unrolled(const_pointer other, std::index_sequence<I...>) const noexcept
+            {
+                if constexpr (std::is_scalar_v<value_type>) { return (true & ... & (m_array[I] == other[I])); }
+                else { return (true && ... && (m_array[I] == other[I])); }
+            }
+
+            template <size_t... I>
+            constexpr void fill_unrolled(const_reference val, std::index_sequence<I...>)
+            {
+                ((m_array[I] = val), ...);
+            }
+
+            // every element is read before any is written so overlapping views are handled like memmove
+            template <size_t... I>
+            constexpr void copy_unrolled(const_pointer src, pointer dest, std::index_sequence<I...>) const noexcept
+            {
+                const value_type tmp[] = {src[I]...};
+                ((dest[I] = tmp[I]), ...);
+            }
+
+            template <size_t... I>
+            constexpr void swap_unrolled(pointer a, pointer b, std::index_sequence<I...>) const noexcept
             {
-                throw std::out_of_range(std::string("Out of range: ") + std::to_string(pos));
+                const value_type tmp[] = {a[I]...};
+                ((a[I] = b[I]), ...);
+                ((b[I] = tmp[I]), ...);
+            }
+
+            // bytes of the wrapped array, as reported to the instrumentation
+            constexpr size_t size_bytes() const noexcept { return size() * sizeof(value_type); }
+
+            constexpr void copy_elements(const_pointer src, pointer dest) const
+            {
+                const auto trace = detail::begin_operation(Wrapper_Operation::Assign, dest, size_bytes());
+                if constexpr (is_copy_unrolled)
+                {
+                    copy_unrolled(src, dest, unrolled_indices());
+                }
+                else if (detail::is_constant_evaluated())
+                {
+                    if (constant_overlaps_forward(src, dest)) { for (size_type i = size(); i-- > 0;) { dest[i] = src[i]; } }
+                    else { for (size_type i = 0; i < size(); ++i) { dest[i] = src[i]; } }
+                }
+                else if constexpr (detail::is_bitwise_copy_assignable_v<value_type>)
+                {
+                    bitwise_copy(src, dest);
+                }
+                else
+                {
+                    if (overlaps_forward(src, dest)) { std::copy_backward(src, src + size(), dest + size()); }
+                    else { std::copy(src, src + size(), dest); }
+                }
+                detail::end_operation(trace);
+            }
+
+            constexpr void move_elements(pointer src, pointer dest) const
+            {
+                const auto trace = detail::begin_operation(Wrapper_Operation::Assign, dest, size_bytes());
+                if constexpr (is_copy_unrolled && detail::is_bitwise_move_assignable_v<value_type>)
+                {
+                    copy_unrolled(src, dest, unrolled_indices());
+                }
+                else if (detail::is_constant_evaluated())
+                {
+                    if (constant_overlaps_forward(src, dest)) { for (size_type i = size(); i-- > 0;) { dest[i] = std::move(src[i]); } }
+                    else { for (size_type i = 0; i < size(); ++i) { dest[i] = std::move(src[i]); } }
+                }
+                else if constexpr (detail::is_bitwise_move_assignable_v<value_type>)
+                {
+                    bitwise_copy(src, dest);
+                }
+                else
+                {
+                    if (overlaps_forward(src, dest)) { std::move_backward(src, src + size(), dest + size()); }
+                    else { std::move(src, src + size(), dest); }
+                }
+                detail::end_operation(trace);
+            }
+
+            void bitwise_copy(const_pointer src, pointer dest) const noexcept
+            {
+                const size_t bytes = size() * sizeof(value_type);
+
+                if (use_streaming_stores() && !overlaps(src, dest))
+                {
+                    detail::stream_copy(dest, src, bytes);
+                    return;
+                }
+                std::memmove(dest, src, bytes);
+            }
+
+            constexpr void swap_elements(pointer a, pointer b) const
+                noexcept(std::is_nothrow_swappable_v<value_type>)
+            {
+                const auto trace = detail::begin_operation(Wrapper_Operation::Swap, a, size_bytes());
+                if constexpr (is_swap_unrolled)
+                {
+                    swap_unrolled(a, b, unrolled_indices());
+                }
+                else if (detail::is_constant_evaluated())
+                {
+                    // std::swap is only constexpr from C++20
+                    for (size_type i = 0; i < size(); ++i)
+                    {
+                        value_type tmp = std::move(a[i]);
+                        a[i] = std::move(b[i]);
+                        b[i] = std::move(tmp);
+                    }
+                }
+                else if constexpr (detail::is_bitwise_swappable_v<value_type>)
+                {
+                    detail::swap_bytes(a, b, size() * sizeof(value_type));
+                }
+                else
+                {
+                    std::swap_ranges(a, a + size(), b);
+                }
+                detail::end_operation(trace);
+            }
+
+            constexpr void check_same_size(size_type other_size) const
+            {
+                if constexpr (N == dynamic_extent)
+                {
+                    if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(other_size != size())) { detail::raise_length_error(size(), other_size); }
+                }
+            }
+    };
+
+    template <typename T, size_t N>
+    Array_Wrapper(T (&)[N]) -> Array_Wrapper<T, N>;
+
+    template <typename T>
+    Array_Wrapper(T*, size_t) -> Array_Wrapper<T, dynamic_extent>;
+
+    /* HASHING
+       std::hash<Array_Wrapper> hashes the raw bytes of element types whose equality is bytewise,
+       and combines std::hash of each element otherwise. Specialise is_bytewise_hashable for other
+       types where equal values always have equal bytes, e.g. packed structs with a defaulted ==. */
+
+    template <typename T>
+    struct is_bytewise_hashable : std::bool_constant<detail::is_bitwise_comparable_v<T>> {};
+
+    namespace detail
+    {
+        // 64 x 64 -> 128 bit multiply folded back to 64 bits, the core of wyhash
+        inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ typedef unsigned __int128 uint128; // not standard C++, so -Wpedantic would warn
+            const uint128 product = static_cast<uint128>(a) * b;
+            return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            std::uint64_t high;
+            const std::uint64_t low = _umul128(a, b, &high);
+            return low ^ high;
+#else
+            const std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+            const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+            const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+            const std::uint64_t high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+            const std::uint64_t low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+            return low ^ high;
+#endif
+        }
+
+        inline constexpr std::uint64_t hash_primes[4] =
+            {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+        inline std::uint64_t read_u64(const unsigned char* p) noexcept { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+        inline std::uint64_t read_u32(const unsigned char* p) noexcept { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+
+        // wyhash, three independent lanes over 48 byte blocks keep the multipliers busy
+        inline std::uint64_t hash_bytes(const void* data_, size_t bytes, std::uint64_t seed = 0) noexcept
+        {
+            const auto* p = static_cast<const unsigned char*>(data_);
+            seed ^= mix(seed ^ hash_primes[0], hash_primes[1]);
+
+            std::uint64_t a = 0, b = 0;
+            if (bytes <= 16)
+            {
+                if (bytes >= 4)
+                {
+                    const size_t middle = (bytes >> 3) << 2;
+                    a = (read_u32(p) << 32) | read_u32(p + middle);
+                    b = (read_u32(p + bytes - 4) << 32) | read_u32(p + bytes - 4 - middle);
+                }
+                else if (bytes > 0)
+                {
+                    a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[bytes >> 1]) << 8) | p[bytes - 1];
+                }
+            }
+            else
+            {
+                size_t remaining = bytes;
+                if (remaining > 48)
+                {
+                    std::uint64_t seed1 = seed, seed2 = seed;
+                    do
+                    {
+                        seed = mix(read_u64(p) ^ hash_primes[1], read_u64(p + 8) ^ seed);
+                        seed1 = mix(read_u64(p + 16) ^ hash_primes[2], read_u64(p + 24) ^ seed1);
+                        seed2 = mix(read_u64(p + 32) ^ hash_primes[3], read_u64(p + 40) ^ seed2);
+                        p += 48;
+                        remaining -= 48;
+                    } while (remaining > 48);
+                    seed ^= seed1 ^ seed2;
+                }
+                while (remaining > 16)
+                {
+                    seed = mix(read_u64(p) ^ hash_primes[1], read_u64(p + 8) ^ seed);
+                    p += 16;
+                    remaining -= 16;
+                }
+                a = read_u64(p + remaining - 16);
+                b = read_u64(p + remaining - 8);
+            }
+
+            return mix(hash_primes[1] ^ bytes, mix(a ^ hash_primes[1], b ^ seed));
+        }
+
+        template <typename T>
+        inline size_t hash_elements(const T* data_, size_t count)
+        {
+            using value_type = std::remove_cv_t<T>;
+
+            if constexpr (is_bytewise_hashable<value_type>::value)
+            {
+                static_assert(std::is_trivially_copyable_v<value_type>);
+                return static_cast<size_t>(hash_bytes(data_, count * sizeof(T)));
+            }
+            else
+            {
+                std::uint64_t h = hash_primes[0] ^ count;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    h = mix(h ^ static_cast<std::uint64_t>(std::hash<value_type>()(data_[i])), hash_primes[1]);
+                }
+                return static_cast<size_t>(h);
+            }
+        }
+    }
+
+    /* Rolling_Hash hashes a sliding window of integral elements in O(1) per step, e.g. for n-gram
+       dedup. The window size is fixed by the wrapper it is constructed from. Equal windows give
+       equal values but the values differ from std::hash<Array_Wrapper>. */
+
+    template <typename T>
+    class Rolling_Hash
+    {
+        public:
+            static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+
+            explicit Rolling_Hash(Array_Wrapper<const T, dynamic_extent> window) noexcept
+                : m_hash(0), m_outgoing_factor(1)
+            {
+                for (size_t i = 0; i < window.size(); ++i)
+                {
+                    m_hash = m_hash * s_base + element_value(window[i]);
+                    if (i > 0) { m_outgoing_factor *= s_base; }
+                }
+            }
+
+            // slide the window one element, outgoing must be the first element of the current window
+            void roll(T outgoing, T incoming) noexcept
+            {
+                m_hash = (m_hash - element_value(outgoing) * m_outgoing_factor) * s_base + element_value(incoming);
+            }
+
+            // the polynomial is finalised so that every bit of the result depends on every element
+            size_t value() const noexcept { return static_cast<size_t>(detail::mix(m_hash ^ detail::hash_primes[0], detail::hash_primes[1])); }
+
+        private:
+            // arithmetic is modulo 2^64, an odd base keeps it invertible
+            static constexpr std::uint64_t s_base = 0x100000001b3ull;
+
+            std::uint64_t m_hash;
+            std::uint64_t m_outgoing_factor;
+
+            static std::uint64_t element_value(T val) noexcept
+            {
+                if constexpr (std::is_enum_v<T>) { return static_cast<std::uint64_t>(static_cast<std::underlying_type_t<T>>(val)); }
+                else { return static_cast<std::uint64_t>(val); }
             }
     };
 }
 
-#endif // FIBB_ARRAY_WRAPPER
+namespace std
+{
+    template <typename T, size_t N>
+    struct hash<fibb::Array_Wrapper<T, N>>
+    {
+        size_t operator()(const fibb::Array_Wrapper<T, N>& wrapper) const
+        {
+            return fibb::detail::hash_elements(wrapper.data(), wrapper.size());
+        }
+    };
+}
 
+#endif // FIBB_ARRAY_WRAPPER
@@ -0,0 +1,328 @@
+#ifndef FIBB_ATOMIC_ARRAY_WRAPPER
+#define FIBB_ATOMIC_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <atomic>
+
+#if defined(__cpp_lib_atomic_ref) && __cpp_lib_atomic_ref >= 201806L
+    #define FIBB_ARRAY_WRAPPER_ATOMIC_REF
+#elif !defined(__GNUC__) && !defined(__clang__)
+    #error "Atomic_Array_Wrapper needs std::atomic_ref (C++20) or the GCC __atomic builtins"
+#endif
+
+namespace fibb
+{
+    // Element of a padded atomic array, each one has a cache line to itself so that threads updating
+    // neighbouring elements do not contend for the same line
+    template <typename T>
+    struct alignas(FIBB_ARRAY_WRAPPER_CACHE_LINE) Cache_Padded
+    {
+        T value;
+    };
+
+#if defined(FIBB_ARRAY_WRAPPER_ATOMIC_REF)
+    template <typename T>
+    using Atomic_Ref = std::atomic_ref<T>;
+#else
+    /* Stand-in for std::atomic_ref before C++20 built on the GCC __atomic builtins, which accept
+       the same memory orders. Only the members used by Atomic_Array_Wrapper are provided. */
+
+    template <typename T>
+    class Atomic_Ref
+    {
+        public:
+            using value_type = T;
+            using difference_type = T;
+
+            static constexpr bool is_always_lock_free = __atomic_always_lock_free(sizeof(T), 0);
+            static constexpr size_t required_alignment = sizeof(T) > alignof(T) && (sizeof(T) & (sizeof(T) - 1)) == 0
+                && sizeof(T) <= 16 ? sizeof(T) : alignof(T);
+
+            explicit Atomic_Ref(T& object_) noexcept : m_object(&object_) {}
+
+            Atomic_Ref(const Atomic_Ref&) = default;
+            Atomic_Ref& operator=(const Atomic_Ref&) = delete;
+
+            bool is_lock_free() const noexcept { return __atomic_is_lock_free(sizeof(T), m_object); }
+
+            T load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                T result;
+                __atomic_load(m_object, &result, static_cast<int>(order));
+                return result;
+            }
+
+            void store(T desired, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                __atomic_store(m_object, &desired, static_cast<int>(order));
+            }
+
+            T exchange(T desired, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                T result;
+                __atomic_exchange(m_object, &desired, &result, static_cast<int>(order));
+                return result;
+            }
+
+            bool compare_exchange_weak(T& expected, T desired, std::memory_order success, std::memory_order failure) const noexcept
+            {
+                return __atomic_compare_exchange(m_object, &expected, &desired, true, static_cast<int>(success), static_cast<int>(failure));
+            }
+
+            bool compare_exchange_strong(T& expected, T desired, std::memory_order success, std::memory_order failure) const noexcept
+            {
+                return __atomic_compare_exchange(m_object, &expected, &desired, false, static_cast<int>(success), static_cast<int>(failure));
+            }
+
+            bool compare_exchange_weak(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return compare_exchange_weak(expected, desired, order, failure_order(order));
+            }
+
+            bool compare_exchange_strong(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return compare_exchange_strong(expected, desired, order, failure_order(order));
+            }
+
+            T fetch_add(T arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    T expected = load(std::memory_order_relaxed);
+                    while (!compare_exchange_weak(expected, expected + arg, order, std::memory_order_relaxed)) {}
+                    return expected;
+                }
+                else
+                {
+                    return __atomic_fetch_add(m_object, arg, static_cast<int>(order));
+                }
+            }
+
+            T fetch_sub(T arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    T expected = load(std::memory_order_relaxed);
+                    while (!compare_exchange_weak(expected, expected - arg, order, std::memory_order_relaxed)) {}
+                    return expected;
+                }
+                else
+                {
+                    return __atomic_fetch_sub(m_object, arg, static_cast<int>(order));
+                }
+            }
+
+            T fetch_and(T arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return __atomic_fetch_and(m_object, arg, static_cast<int>(order));
+            }
+
+            T fetch_or(T arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return __atomic_fetch_or(m_object, arg, static_cast<int>(order));
+            }
+
+            T fetch_xor(T arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return __atomic_fetch_xor(m_object, arg, static_cast<int>(order));
+            }
+
+        private:
+            T* m_object;
+
+            // same rule as std::atomic, a failed exchange performs no store
+            static constexpr std::memory_order failure_order(std::memory_order order) noexcept
+            {
+                return order == std::memory_order_acq_rel ? std::memory_order_acquire
+                    : order == std::memory_order_release ? std::memory_order_relaxed : order;
+            }
+    };
+#endif
+
+    /* The Atomic_Array_Wrapper gives atomic access to the elements of a raw array which is shared
+       between threads, without changing the array's type. Every access goes through an Atomic_Ref so
+       each operation takes an explicit memory order, defaulting to seq_cst as std::atomic does.
+
+       With Padded set the wrapped array is made of Cache_Padded<T> elements instead of T, so that
+       per-thread counters or statistics next to each other don't cause false sharing.
+
+       The array has to satisfy Atomic_Ref<T>::required_alignment, which is checked on construction.
+       While a wrapper exists the elements must only be accessed atomically. Copying the wrapper copies
+       the view, there is no assignment since element-wise atomic copies would not be atomic as a whole. */
+
+    template <typename T, size_t N, bool Padded = false>
+    class Atomic_Array_Wrapper : private detail::Extent<N>
+    {
+        private:
+            using extent_type = detail::Extent<N>;
+
+            static_assert(std::is_trivially_copyable_v<T> && !std::is_const_v<T> && !std::is_volatile_v<T>);
+
+        public:
+            /* TYPES */
+            using value_type = T;
+            using element_type = std::conditional_t<Padded, Cache_Padded<T>, T>; // what the wrapped array holds
+            using pointer = element_type*;
+            using reference = Atomic_Ref<T>;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+
+            static constexpr size_type extent = N;
+            static constexpr bool is_always_lock_free = reference::is_always_lock_free;
+
+            /* CONSTRUCTORS */
+            template <size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            Atomic_Array_Wrapper(element_type (&array_)[M]) // sized array
+                : extent_type(M), m_array(checked_pointer(array_))
+            {}
+
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            Atomic_Array_Wrapper(pointer& array_) // decayed array pointer
+                : extent_type(N), m_array(checked_pointer(array_))
+            {}
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            Atomic_Array_Wrapper(pointer array_, size_type size_) // pointer and runtime size
+                : extent_type(size_), m_array(checked_pointer(array_))
+            {}
+
+            template <size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            Atomic_Array_Wrapper(Array_Wrapper<element_type, M> array_)
+                : extent_type(array_.size()), m_array(checked_pointer(array_.data()))
+            {}
+
+            Atomic_Array_Wrapper(const Atomic_Array_Wrapper&) = default;
+            Atomic_Array_Wrapper& operator=(const Atomic_Array_Wrapper&) = delete;
+
+            /* ELEMENT ACCESS */
+            reference operator[](size_type pos) const noexcept
+            {
+                detail::check_access(pos, size());
+                return reference(element(pos));
+            }
+
+            reference at(size_type pos) const
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size())) { detail::raise_range_error(pos); }
+                return reference(element(pos));
+            }
+
+            // shorthands for (*this)[pos].operation(...)
+            value_type load(size_type pos, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].load(order);
+            }
+
+            void store(size_type pos, value_type desired, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                (*this)[pos].store(desired, order);
+            }
+
+            value_type exchange(size_type pos, value_type desired, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].exchange(desired, order);
+            }
+
+            bool compare_exchange_weak(size_type pos, value_type& expected, value_type desired,
+                std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].compare_exchange_weak(expected, desired, order);
+            }
+
+            bool compare_exchange_weak(size_type pos, value_type& expected, value_type desired,
+                std::memory_order success, std::memory_order failure) const noexcept
+            {
+                return (*this)[pos].compare_exchange_weak(expected, desired, success, failure);
+            }
+
+            bool compare_exchange_strong(size_type pos, value_type& expected, value_type desired,
+                std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].compare_exchange_strong(expected, desired, order);
+            }
+
+            bool compare_exchange_strong(size_type pos, value_type& expected, value_type desired,
+                std::memory_order success, std::memory_order failure) const noexcept
+            {
+                return (*this)[pos].compare_exchange_strong(expected, desired, success, failure);
+            }
+
+            // arithmetic is available for integers, and for floating point as far as Atomic_Ref supports it
+            template <typename U = T, std::enable_if_t<std::is_arithmetic_v<U>, int> = 0>
+            value_type fetch_add(size_type pos, value_type arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].fetch_add(arg, order);
+            }
+
+            template <typename U = T, std::enable_if_t<std::is_arithmetic_v<U>, int> = 0>
+            value_type fetch_sub(size_type pos, value_type arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].fetch_sub(arg, order);
+            }
+
+            template <typename U = T, std::enable_if_t<std::is_integral_v<U>, int> = 0>
+            value_type fetch_and(size_type pos, value_type arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].fetch_and(arg, order);
+            }
+
+            template <typename U = T, std::enable_if_t<std::is_integral_v<U>, int> = 0>
+            value_type fetch_or(size_type pos, value_type arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].fetch_or(arg, order);
+            }
+
+            template <typename U = T, std::enable_if_t<std::is_integral_v<U>, int> = 0>
+            value_type fetch_xor(size_type pos, value_type arg, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                return (*this)[pos].fetch_xor(arg, order);
+            }
+
+            // stores to every element, each store is atomic but the fill as a whole is not
+            void fill(value_type val, std::memory_order order = std::memory_order_seq_cst) const noexcept
+            {
+                for (size_type i = 0; i < size(); ++i) { reference(element(i)).store(val, order); }
+            }
+
+            /* CAPACITY */
+            constexpr size_type size() const noexcept { return extent_type::size(); }
+            constexpr bool empty() const noexcept { return size() == 0; }
+
+            constexpr pointer data() const noexcept { return m_array; }
+
+        private:
+            pointer m_array;
+
+            T& element(size_type pos) const noexcept
+            {
+                if constexpr (Padded) { return m_array[pos].value; }
+                else { return m_array[pos]; }
+            }
+
+            static pointer checked_pointer(pointer array_)
+            {
+                constexpr size_t alignment = reference::required_alignment;
+                const auto address = reinterpret_cast<std::uintptr_t>(array_);
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(address % alignment != 0))
+                {
+                    detail::raise_invalid_argument("Misaligned atomic array: ", address);
+                }
+                return array_;
+            }
+    };
+
+    template <typename T, size_t N>
+    Atomic_Array_Wrapper(T (&)[N]) -> Atomic_Array_Wrapper<T, N>;
+
+    template <typename T, size_t N>
+    Atomic_Array_Wrapper(Cache_Padded<T> (&)[N]) -> Atomic_Array_Wrapper<T, N, true>;
+
+    template <typename T>
+    Atomic_Array_Wrapper(T*, size_t) -> Atomic_Array_Wrapper<T, dynamic_extent>;
+
+    template <typename T>
+    Atomic_Array_Wrapper(Cache_Padded<T>*, size_t) -> Atomic_Array_Wrapper<T, dynamic_extent, true>;
+}
+
+#endif
@@ -0,0 +1,391 @@
+#include "array_wrapper.hpp"
+#include "expression_array_wrapper.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __has_include(<span>) && __cplusplus >= 202002L
+    #include <span>
+    #define FIBB_BENCH_SPAN
+#endif
+
+// Every operation of Array_Wrapper against std::array, std::span where the standard library has
+// it, and a hand written loop over a raw pointer, for small, large, trivial and non-trivial elements.
+//   c++ -std=c++17 -O2 -march=native -I.. array_wrapper_bench.cpp && ./a.out copy/int
+
+using fibb::bench::add;
+using fibb::bench::do_not_optimize;
+
+namespace
+{
+    // a trivially copyable element too large to be compared or copied a vector at a time
+    struct Large
+    {
+        double values[16];
+
+        friend bool operator==(const Large& a, const Large& b) { return std::equal(a.values, a.values + 16, b.values); }
+        friend bool operator<(const Large& a, const Large& b) { return std::lexicographical_compare(a.values, a.values + 16, b.values, b.values + 16); }
+    };
+
+    template <typename T>
+    T value_at(size_t i)
+    {
+        if constexpr (std::is_same_v<T, Large>)
+        {
+            Large large{};
+            for (double& value : large.values) { value = static_cast<double>(i); }
+            return large;
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            return std::string(24 + i % 8, static_cast<char>('a' + i % 26)); // too long for the small string buffer
+        }
+        else
+        {
+            return static_cast<T>(i * 7 + 1);
+        }
+    }
+
+    template <typename T>
+    size_t weight(const T& x)
+    {
+        if constexpr (std::is_same_v<T, Large>) { return static_cast<size_t>(x.values[0]); }
+        else if constexpr (std::is_same_v<T, std::string>) { return x.size(); }
+        else { return static_cast<size_t>(x); }
+    }
+
+    // a and b, and sa and sb, start with equal elements; c holds other values
+    template <typename T, size_t N>
+    struct Fixture
+    {
+        std::vector<T> a, b, c;
+        std::array<T, N> sa, sb;
+
+        Fixture() : a(N), b(N), c(N)
+        {
+            for (size_t i = 0; i < N; ++i)
+            {
+                a[i] = b[i] = sa[i] = sb[i] = value_at<T>(i);
+                c[i] = value_at<T>(i + 1);
+            }
+        }
+    };
+
+    template <typename T, size_t N>
+    using Fixture_Ptr = std::shared_ptr<Fixture<T, N>>;
+
+    template <typename T, size_t N>
+    Fixture_Ptr<T, N> make_fixture() { return std::make_shared<Fixture<T, N>>(); }
+
+    /* CONSTRUCTION AND ELEMENT ACCESS */
+    template <typename T, size_t N>
+    void add_access(const std::string& suffix)
+    {
+        const auto f = make_fixture<T, N>();
+        const size_t bytes = N * sizeof(T);
+
+        add("construct" + suffix, "Array_Wrapper", 0, [f] { T* p = f->a.data(); fibb::Array_Wrapper<T, N> w(p); do_not_optimize(w); });
+        add("construct" + suffix, "Array_Wrapper (dynamic)", 0, [f] { fibb::Array_Wrapper<T, fibb::dynamic_extent> w(f->a.data(), N); do_not_optimize(w); });
+        add("construct" + suffix, "raw pointer", 0, [f] { T* p = f->a.data(); do_not_optimize(p); });
+#if defined(FIBB_BENCH_SPAN)
+        add("construct" + suffix, "std::span", 0, [f] { std::span<T, N> s(f->a.data(), N); do_not_optimize(s); });
+#endif
+
+        add("operator[]" + suffix, "Array_Wrapper", bytes, [f]
+        {
+            T* p = f->a.data();
+            const fibb::Array_Wrapper<T, N> w(p);
+            size_t sum = 0;
+            for (size_t i = 0; i < w.size(); ++i) { sum += weight(w[i]); }
+            do_not_optimize(sum);
+        });
+        add("operator[]" + suffix, "Array_Wrapper (dynamic)", bytes, [f]
+        {
+            const fibb::Array_Wrapper<T, fibb::dynamic_extent> w(f->a.data(), N);
+            size_t sum = 0;
+            for (size_t i = 0; i < w.size(); ++i) { sum += weight(w[i]); }
+            do_not_optimize(sum);
+        });
+        add("operator[]" + suffix, "std::array", bytes, [f]
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < N; ++i) { sum += weight(f->sa[i]); }
+            do_not_optimize(sum);
+        });
+        add("operator[]" + suffix, "raw loop", bytes, [f]
+        {
+            const T* p = f->a.data();
+            size_t sum = 0;
+            for (size_t i = 0; i < N; ++i) { sum += weight(p[i]); }
+            do_not_optimize(sum);
+        });
+#if defined(FIBB_BENCH_SPAN)
+        add("operator[]" + suffix, "std::span", bytes, [f]
+        {
+            const std::span<const T, N> s(f->a.data(), N);
+            size_t sum = 0;
+            for (size_t i = 0; i < s.size(); ++i) { sum += weight(s[i]); }
+            do_not_optimize(sum);
+        });
+#endif
+
+        add("at" + suffix, "Array_Wrapper", bytes, [f]
+        {
+            T* p = f->a.data();
+            const fibb::Array_Wrapper<T, N> w(p);
+            size_t sum = 0;
+            for (size_t i = 0; i < w.size(); ++i) { sum += weight(w.at(i)); }
+            do_not_optimize(sum);
+        });
+        add("at" + suffix, "std::array", bytes, [f]
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < N; ++i) { sum += weight(f->sa.at(i)); }
+            do_not_optimize(sum);
+        });
+        add("at" + suffix, "raw loop", bytes, [f]
+        {
+            const T* p = f->a.data();
+            size_t sum = 0;
+            for (size_t i = 0; i < N; ++i) { sum += weight(p[i]); }
+            do_not_optimize(sum);
+        });
+    }
+
+    /* FILL AND SWAP */
+    template <typename T, size_t N>
+    void add_fill_swap(const std::string& suffix)
+    {
+        const size_t bytes = N * sizeof(T);
+
+        const auto f = make_fixture<T, N>();
+        const T value = value_at<T>(3);
+        add("fill" + suffix, "Array_Wrapper", bytes, [f, value] { T* p = f->a.data(); fibb::Array_Wrapper<T, N> x(p); x.fill(value); });
+        add("fill" + suffix, "Array_Wrapper (dynamic)", bytes, [f, value] { fibb::Array_Wrapper<T, fibb::dynamic_extent>(f->a.data(), N).fill(value); });
+        add("fill" + suffix, "std::array", bytes, [f, value] { f->sa.fill(value); });
+        add("fill" + suffix, "raw loop", bytes, [f, value] { T* p = f->a.data(); for (size_t i = 0; i < N; ++i) { p[i] = value; } });
+#if defined(FIBB_BENCH_SPAN)
+        add("fill" + suffix, "std::span", bytes, [f, value] { std::span<T, N> s(f->a.data(), N); std::fill(s.begin(), s.end(), value); });
+#endif
+
+        const auto g = make_fixture<T, N>();
+        add("swap" + suffix, "Array_Wrapper", bytes, [g]
+        {
+            T* p = g->a.data();
+            T* q = g->c.data();
+            fibb::Array_Wrapper<T, N> x(p);
+            fibb::Array_Wrapper<T, N> y(q);
+            x.swap(y);
+        });
+        add("swap" + suffix, "Array_Wrapper (dynamic)", bytes, [g]
+        {
+            fibb::Array_Wrapper<T, fibb::dynamic_extent> x(g->a.data(), N);
+            fibb::Array_Wrapper<T, fibb::dynamic_extent> y(g->c.data(), N);
+            x.swap(y);
+        });
+        add("swap" + suffix, "Array_Wrapper with std::array", bytes, [g] { T* p = g->a.data(); fibb::Array_Wrapper<T, N> x(p); x.swap(g->sb); });
+        add("swap" + suffix, "std::array", bytes, [g] { g->sa.swap(g->sb); });
+        add("swap" + suffix, "raw loop", bytes, [g]
+        {
+            T* p = g->a.data();
+            T* q = g->c.data();
+            for (size_t i = 0; i < N; ++i) { std::swap(p[i], q[i]); }
+        });
+    }
+
+    /* ASSIGNMENT */
+    template <typename T, size_t N>
+    void add_assignment(const std::string& suffix)
+    {
+        const size_t bytes = N * sizeof(T);
+
+        const auto f = make_fixture<T, N>();
+        add("copy" + suffix, "Array_Wrapper", bytes, [f]
+        {
+            T* p = f->a.data();
+            T* q = f->c.data();
+            fibb::Array_Wrapper<T, N> x(p);
+            const fibb::Array_Wrapper<T, N> y(q);
+            x = y;
+        });
+        add("copy" + suffix, "Array_Wrapper (dynamic)", bytes, [f]
+        {
+            T* q = f->c.data();
+            fibb::Array_Wrapper<T, fibb::dynamic_extent> x(f->a.data(), N);
+            const fibb::Array_Wrapper<T, N> y(q);
+            x = y;
+        });
+        add("copy" + suffix, "Array_Wrapper (const source)", bytes, [f]
+        {
+            T* p = f->a.data();
+            const T* q = f->c.data();
+            fibb::Array_Wrapper<T, N> x(p);
+            x = fibb::Array_Wrapper<const T, N>(q);
+        });
+        add("copy" + suffix, "Array_Wrapper from std::array", bytes, [f] { T* p = f->a.data(); fibb::Array_Wrapper<T, N> x(p); x = f->sb; });
+        add("copy" + suffix, "std::array", bytes, [f] { f->sa = f->sb; });
+        add("copy" + suffix, "raw loop", bytes, [f]
+        {
+            T* p = f->a.data();
+            const T* q = f->c.data();
+            for (size_t i = 0; i < N; ++i) { p[i] = q[i]; }
+        });
+#if defined(FIBB_BENCH_SPAN)
+        add("copy" + suffix, "std::span", bytes, [f]
+        {
+            const std::span<const T, N> s(f->c.data(), N);
+            std::copy(s.begin(), s.end(), std::span<T, N>(f->a.data(), N).begin());
+        });
+#endif
+
+        // moved from elements are moved back, so every iteration moves the same values
+        const auto g = make_fixture<T, N>();
+        add("move there and back" + suffix, "Array_Wrapper", 2 * bytes, [g]
+        {
+            T* p = g->a.data();
+            T* q = g->c.data();
+            fibb::Array_Wrapper<T, N> x(p);
+            fibb::Array_Wrapper<T, N> y(q);
+            x = std::move(y);
+            y = std::move(x);
+        });
+        add("move there and back" + suffix, "Array_Wrapper (dynamic)", 2 * bytes, [g]
+        {
+            fibb::Array_Wrapper<T, fibb::dynamic_extent> x(g->a.data(), N);
+            fibb::Array_Wrapper<T, fibb::dynamic_extent> y(g->c.data(), N);
+            x = std::move(y);
+            y = std::move(x);
+        });
+        add("move there and back" + suffix, "Array_Wrapper from std::array", 2 * bytes, [g]
+        {
+            T* p = g->a.data();
+            T* q = g->sb.data();
+            fibb::Array_Wrapper<T, N> x(p);
+            fibb::Array_Wrapper<T, N> y(q);
+            x = std::move(g->sb);
+            y = std::move(x);
+        });
+        add("move there and back" + suffix, "std::array", 2 * bytes, [g] { g->sa = std::move(g->sb); g->sb = std::move(g->sa); });
+        add("move there and back" + suffix, "raw loop", 2 * bytes, [g]
+        {
+            T* p = g->a.data();
+            T* q = g->c.data();
+            for (size_t i = 0; i < N; ++i) { p[i] = std::move(q[i]); }
+            for (size_t i = 0; i < N; ++i) { q[i] = std::move(p[i]); }
+        });
+
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            const auto h = make_fixture<T, N>();
+            add("expression" + suffix, "Array_Wrapper", bytes, [h]
+            {
+                T* p = h->a.data();
+                T* q = h->b.data();
+                T* r = h->c.data();
+                fibb::Array_Wrapper<T, N> x(p);
+                const fibb::Array_Wrapper<T, N> y(q);
+                const fibb::Array_Wrapper<T, N> z(r);
+                x = y * 3 + z;
+            });
+            add("expression" + suffix, "raw loop", bytes, [h]
+            {
+                T* p = h->a.data();
+                const T* q = h->b.data();
+                const T* r = h->c.data();
+                for (size_t i = 0; i < N; ++i) { p[i] = q[i] * 3 + r[i]; }
+            });
+        }
+    }
+
+    /* COMPARISON */
+    // the arrays are equal, which is the worst case for every operator as it reads them to the end
+    template <typename T, size_t N>
+    bool raw_less(const T* a, const T* b)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (a[i] < b[i]) { return true; }
+            if (b[i] < a[i]) { return false; }
+        }
+        return false;
+    }
+
+    template <typename T, size_t N>
+    bool raw_equal(const T* a, const T* b)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (!(a[i] == b[i])) { return false; }
+        }
+        return true;
+    }
+
+    template <typename T, size_t N, typename Wrapper_Op, typename Array_Op, typename Raw_Op>
+    void add_comparison(const std::string& group, const Fixture_Ptr<T, N>& f, Wrapper_Op wrapper_op, Array_Op array_op, Raw_Op raw_op)
+    {
+        const size_t bytes = N * sizeof(T);
+        add(group, "Array_Wrapper", bytes, [f, wrapper_op]
+        {
+            T* p = f->a.data();
+            T* q = f->b.data();
+            const bool result = wrapper_op(fibb::Array_Wrapper<T, N>(p), fibb::Array_Wrapper<T, N>(q));
+            do_not_optimize(result);
+        });
+        add(group, "Array_Wrapper (dynamic)", bytes, [f, wrapper_op]
+        {
+            const bool result = wrapper_op(fibb::Array_Wrapper<T, fibb::dynamic_extent>(f->a.data(), N),
+                fibb::Array_Wrapper<T, fibb::dynamic_extent>(f->b.data(), N));
+            do_not_optimize(result);
+        });
+        add(group, "std::array", bytes, [f, array_op] { const bool result = array_op(f->sa, f->sb); do_not_optimize(result); });
+        add(group, "raw loop", bytes, [f, raw_op] { const bool result = raw_op(f->a.data(), f->b.data()); do_not_optimize(result); });
+    }
+
+    template <typename T, size_t N>
+    void add_comparisons(const std::string& suffix)
+    {
+        const auto f = make_fixture<T, N>();
+        const auto equal = [] (const auto& a, const auto& b) { return a == b; };
+        const auto not_equal = [] (const auto& a, const auto& b) { return a != b; };
+        const auto less = [] (const auto& a, const auto& b) { return a < b; };
+        const auto greater = [] (const auto& a, const auto& b) { return a > b; };
+        const auto less_equal = [] (const auto& a, const auto& b) { return a <= b; };
+        const auto greater_equal = [] (const auto& a, const auto& b) { return a >= b; };
+
+        add_comparison("==" + suffix, f, equal, equal, raw_equal<T, N>);
+        add_comparison("!=" + suffix, f, not_equal, not_equal, [] (const T* a, const T* b) { return !raw_equal<T, N>(a, b); });
+        add_comparison("<" + suffix, f, less, less, raw_less<T, N>);
+        add_comparison(">" + suffix, f, greater, greater, [] (const T* a, const T* b) { return raw_less<T, N>(b, a); });
+        add_comparison("<=" + suffix, f, less_equal, less_equal, [] (const T* a, const T* b) { return !raw_less<T, N>(b, a); });
+        add_comparison(">=" + suffix, f, greater_equal, greater_equal, [] (const T* a, const T* b) { return !raw_less<T, N>(a, b); });
+    }
+
+    template <typename T, size_t... N>
+    void add_type(const char* type_name)
+    {
+        const auto add_size = [type_name] (auto n)
+        {
+            constexpr size_t size = decltype(n)::value;
+            const std::string suffix = std::string("/") + type_name + "/" + std::to_string(size);
+            add_access<T, size>(suffix);
+            add_fill_swap<T, size>(suffix);
+            add_assignment<T, size>(suffix);
+            add_comparisons<T, size>(suffix);
+        };
+        (add_size(std::integral_constant<size_t, N>()), ...);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    add_type<int, 4, 16, 256, 4096>("int");
+    add_type<double, 16, 4096>("double");
+    add_type<Large, 4, 64, 1024>("Large");
+    add_type<std::string, 4, 64, 1024>("std::string");
+    return fibb::bench::run(argc, argv);
+}
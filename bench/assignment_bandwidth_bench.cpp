@@ -0,0 +1,107 @@
+#include "array_wrapper.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Memory bandwidth of assignment and swap, which decide aliasing by pointer identity, against
+// comparing the elements first as they once did and against memcpy and memmove. Frames range
+// from cache sized to past the streaming store threshold.
+//   c++ -std=c++17 -O2 -march=native -I.. assignment_bandwidth_bench.cpp && ./a.out
+
+using fibb::bench::add;
+
+namespace
+{
+    using Sample = std::uint32_t;
+
+    // Each iteration assigns the two sources in turn. They only differ in their last element, the worst
+    // case for comparing first: every compare reads both frames to the end and then copies anyway.
+    struct Frames
+    {
+        std::vector<Sample> dest, first, second;
+
+        explicit Frames(size_t n) : dest(n), first(n), second(n)
+        {
+            for (size_t i = 0; i < n; ++i) { first[i] = second[i] = static_cast<Sample>(i * 2654435761u); }
+            second[n - 1] ^= 1;
+        }
+    };
+
+    template <size_t Bytes>
+    void add_frame()
+    {
+        constexpr size_t n = Bytes / sizeof(Sample);
+        const std::string suffix = "/" + std::to_string(Bytes / 1024) + " KiB";
+        const auto f = std::make_shared<Frames>(n);
+
+        add("assign" + suffix, "Array_Wrapper", 2 * Bytes, [f]
+        {
+            Sample* d = f->dest.data();
+            Sample* a = f->first.data();
+            Sample* b = f->second.data();
+            fibb::Array_Wrapper<Sample, n> dest(d);
+            dest = fibb::Array_Wrapper<Sample, n>(a);
+            dest = fibb::Array_Wrapper<Sample, n>(b);
+        });
+        add("assign" + suffix, "Array_Wrapper (dynamic)", 2 * Bytes, [f]
+        {
+            fibb::Array_Wrapper<Sample, fibb::dynamic_extent> dest(f->dest.data(), n);
+            dest = fibb::Array_Wrapper<const Sample, fibb::dynamic_extent>(f->first.data(), n);
+            dest = fibb::Array_Wrapper<const Sample, fibb::dynamic_extent>(f->second.data(), n);
+        });
+        add("assign" + suffix, "compare then copy", 2 * Bytes, [f]
+        {
+            for (const std::vector<Sample>* src : {&f->first, &f->second})
+            {
+                if (!std::equal(src->begin(), src->end(), f->dest.begin())) { std::copy(src->begin(), src->end(), f->dest.begin()); }
+            }
+        });
+        add("assign" + suffix, "memcpy", 2 * Bytes, [f]
+        {
+            std::memcpy(f->dest.data(), f->first.data(), Bytes);
+            std::memcpy(f->dest.data(), f->second.data(), Bytes);
+        });
+
+        add("swap" + suffix, "Array_Wrapper", Bytes, [f]
+        {
+            Sample* a = f->first.data();
+            Sample* b = f->second.data();
+            fibb::Array_Wrapper<Sample, n> x(a);
+            fibb::Array_Wrapper<Sample, n> y(b);
+            x.swap(y);
+        });
+        add("swap" + suffix, "compare then swap", Bytes, [f]
+        {
+            if (f->first != f->second) { std::swap_ranges(f->first.begin(), f->first.end(), f->second.begin()); }
+        });
+        add("swap" + suffix, "std::swap_ranges", Bytes, [f] { std::swap_ranges(f->first.begin(), f->first.end(), f->second.begin()); });
+
+        // a view assigned to itself shifted by one element, which has to be copied like memmove
+        add("overlapping assign" + suffix, "Array_Wrapper", Bytes, [f]
+        {
+            fibb::Array_Wrapper<Sample, fibb::dynamic_extent> frame(f->dest.data(), n);
+            frame.subspan(1) = frame.first(n - 1);
+            frame.first(n - 1) = frame.subspan(1);
+        });
+        add("overlapping assign" + suffix, "memmove", Bytes, [f]
+        {
+            Sample* d = f->dest.data();
+            std::memmove(d + 1, d, (n - 1) * sizeof(Sample));
+            std::memmove(d, d + 1, (n - 1) * sizeof(Sample));
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    add_frame<4 * 1024>();
+    add_frame<64 * 1024>();
+    add_frame<1024 * 1024>();
+    add_frame<8 * 1024 * 1024>();
+    return fibb::bench::run(argc, argv);
+}
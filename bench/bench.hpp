@@ -0,0 +1,266 @@
+#ifndef FIBB_BENCH_BENCH
+#define FIBB_BENCH_BENCH
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Each benchmark is a standalone program built from this directory with the repository root on the
+// include path, e.g. c++ -std=c++17 -O2 -I.. array_wrapper_bench.cpp. It takes these arguments:
+//   a substring    only runs the cases whose group or name contains it
+//   --gate=R       exits non-zero if an Array_Wrapper case is more than R times slower than the
+//                  fastest baseline of its group, give or take half a nanosecond of timer noise,
+//                  so that it can run as a regression gate
+//   --min-time=MS  time each repetition runs for, 20 by default
+//   --repetitions=N  repetitions of which the fastest is reported, 5 by default
+//   --csv          prints comma separated values rather than a table
+// Define FIBB_BENCH_GOOGLE and link -lbenchmark to run the same cases under Google Benchmark instead.
+#if defined(FIBB_BENCH_GOOGLE) && __has_include(<benchmark/benchmark.h>)
+    #include <benchmark/benchmark.h>
+    #define FIBB_BENCH_USE_GOOGLE
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define FIBB_BENCH_HAS_CYCLES
+#endif
+
+namespace fibb::bench
+{
+    /* OPTIMIZATION BARRIERS */
+    // makes the compiler assume value is read, so the work producing it can't be removed
+    template <typename T>
+    inline void do_not_optimize(const T& value)
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    // makes the compiler assume all memory is read and written, so that work isn't merged or hoisted
+    // across iterations
+    inline void clobber_memory()
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : : "memory");
+#elif defined(_MSC_VER)
+        _ReadWriteBarrier();
+#endif
+    }
+
+    // the time stamp counter ticks at a constant reference rate rather than the core clock, so cycle
+    // counts are only comparable between runs at the same frequency
+    inline std::uint64_t cycles() noexcept
+    {
+#if defined(FIBB_BENCH_HAS_CYCLES)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    /* CASES */
+    // A case is one implementation of an operation. Cases with the same group do the same work on
+    // the same data; those named Array_Wrapper... are gated against the others, the baselines.
+    // bytes is the size of the elements of one wrapped array, which bytes/cycle is reported for.
+    struct Case
+    {
+        std::string group;
+        std::string name;
+        size_t bytes;
+        std::function<void(size_t)> run;
+    };
+
+    inline std::vector<Case>& registry()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    // body runs one iteration, the loop around it is inlined into the case
+    template <typename F>
+    inline void add(std::string group, std::string name, size_t bytes, F body)
+    {
+        registry().push_back(Case{std::move(group), std::move(name), bytes, [body] (size_t iterations) mutable
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                body();
+                clobber_memory();
+            }
+        }});
+    }
+
+    inline bool is_wrapper_case(const Case& case_) { return case_.name.compare(0, 13, "Array_Wrapper") == 0; }
+
+    /* RUNNING */
+    namespace detail
+    {
+        struct Options
+        {
+            std::string filter;
+            double gate = 0;
+            double min_time_ms = 20;
+            int repetitions = 5;
+            bool csv = false;
+        };
+
+        struct Result
+        {
+            double ns = 0;
+            double cycles = 0;
+        };
+
+        inline Options parse_options(int argc, char** argv)
+        {
+            Options options;
+            for (int i = 1; i < argc; ++i)
+            {
+                const char* arg = argv[i];
+                if (std::strncmp(arg, "--gate=", 7) == 0) { options.gate = std::atof(arg + 7); }
+                else if (std::strncmp(arg, "--min-time=", 11) == 0) { options.min_time_ms = std::atof(arg + 11); }
+                else if (std::strncmp(arg, "--repetitions=", 14) == 0) { options.repetitions = std::max(1, std::atoi(arg + 14)); }
+                else if (std::strcmp(arg, "--csv") == 0) { options.csv = true; }
+                else { options.filter = arg; }
+            }
+            return options;
+        }
+
+        // per iteration, the fastest of the repetitions after calibrating the iteration count
+        inline Result measure(const Case& case_, const Options& options)
+        {
+            using clock = std::chrono::steady_clock;
+            const auto time = [&case_] (size_t iterations)
+            {
+                const std::uint64_t start_cycles = cycles();
+                const auto start = clock::now();
+                case_.run(iterations);
+                const auto stop = clock::now();
+                const std::uint64_t stop_cycles = cycles();
+                return std::make_pair(std::chrono::duration<double, std::nano>(stop - start).count(),
+                    static_cast<double>(stop_cycles - start_cycles));
+            };
+
+            const double target_ns = options.min_time_ms * 1e6;
+            size_t iterations = 1;
+            double elapsed = time(iterations).first;
+            while (elapsed < target_ns / 10 && iterations < (size_t(1) << 40))
+            {
+                iterations *= 2;
+                elapsed = time(iterations).first;
+            }
+            iterations = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(iterations) * target_ns / std::max(elapsed, 1.0)));
+
+            Result best{1e300, 1e300};
+            for (int r = 0; r < options.repetitions; ++r)
+            {
+                const auto sample = time(iterations);
+                best.ns = std::min(best.ns, sample.first / static_cast<double>(iterations));
+                best.cycles = std::min(best.cycles, sample.second / static_cast<double>(iterations));
+            }
+            return best;
+        }
+
+        inline bool matches(const Case& case_, const Options& options)
+        {
+            return options.filter.empty() || case_.group.find(options.filter) != std::string::npos
+                || case_.name.find(options.filter) != std::string::npos;
+        }
+    }
+
+    // runs the registered cases and prints a row for each, returns the exit code of the program
+    inline int run(int argc, char** argv)
+    {
+#if defined(FIBB_BENCH_USE_GOOGLE)
+        for (const Case& case_ : registry())
+        {
+            benchmark::RegisterBenchmark((case_.group + "/" + case_.name).c_str(), [&case_] (benchmark::State& state)
+            {
+                for (auto _ : state) { case_.run(1); }
+                state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * case_.bytes));
+            });
+        }
+        benchmark::Initialize(&argc, argv);
+        benchmark::RunSpecifiedBenchmarks();
+        benchmark::Shutdown();
+        return 0;
+#else
+        const detail::Options options = detail::parse_options(argc, argv);
+        const std::vector<Case>& cases = registry();
+        std::vector<detail::Result> results(cases.size());
+        std::vector<bool> selected(cases.size());
+
+#if defined(FIBB_BENCH_HAS_CYCLES)
+        const char* speed_unit = "bytes/cycle";
+#else
+        const char* speed_unit = "bytes/ns";
+#endif
+        if (options.csv) { std::printf("group,case,ns,cycles,%s\n", speed_unit); }
+        else { std::printf("%-36s %-28s %12s %12s %12s\n", "group", "case", "ns/op", "cycles/op", speed_unit); }
+
+        for (size_t i = 0; i < cases.size(); ++i)
+        {
+            selected[i] = detail::matches(cases[i], options);
+            if (!selected[i]) { continue; }
+
+            const detail::Result result = detail::measure(cases[i], options);
+            results[i] = result;
+#if defined(FIBB_BENCH_HAS_CYCLES)
+            const double speed = result.cycles > 0 ? static_cast<double>(cases[i].bytes) / result.cycles : 0;
+#else
+            const double speed = result.ns > 0 ? static_cast<double>(cases[i].bytes) / result.ns : 0;
+#endif
+            if (options.csv)
+            {
+                std::printf("%s,%s,%.3f,%.3f,%.3f\n", cases[i].group.c_str(), cases[i].name.c_str(), result.ns, result.cycles, speed);
+            }
+            else
+            {
+                std::printf("%-36s %-28s %12.2f %12.2f %12.2f\n", cases[i].group.c_str(), cases[i].name.c_str(), result.ns, result.cycles, speed);
+            }
+            std::fflush(stdout);
+        }
+
+        if (options.gate <= 0) { return 0; }
+
+        int failures = 0;
+        for (size_t i = 0; i < cases.size(); ++i)
+        {
+            if (!selected[i] || !is_wrapper_case(cases[i])) { continue; }
+
+            double baseline = 0;
+            for (size_t j = 0; j < cases.size(); ++j)
+            {
+                if (selected[j] && !is_wrapper_case(cases[j]) && cases[j].group == cases[i].group)
+                {
+                    baseline = baseline == 0 ? results[j].ns : std::min(baseline, results[j].ns);
+                }
+            }
+            if (baseline > 0 && results[i].ns > options.gate * baseline + 0.5)
+            {
+                std::fprintf(stderr, "%s %s: %.2f ns is more than %.2f times the baseline's %.2f ns\n",
+                    cases[i].group.c_str(), cases[i].name.c_str(), results[i].ns, options.gate, baseline);
+                ++failures;
+            }
+        }
+        return failures == 0 ? 0 : 1;
+#endif
+    }
+}
+
+#endif
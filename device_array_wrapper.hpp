@@ -0,0 +1,209 @@
+#ifndef FIBB_DEVICE_ARRAY_WRAPPER
+#define FIBB_DEVICE_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+// The copy helpers need the CUDA or HIP runtime, define FIBB_ARRAY_WRAPPER_HIP to pick HIP outside hipcc
+#if defined(__HIPCC__) || (defined(FIBB_ARRAY_WRAPPER_HIP) && __has_include(<hip/hip_runtime_api.h>))
+    #include <hip/hip_runtime_api.h>
+    #define FIBB_ARRAY_WRAPPER_GPU(name) hip##name
+#elif defined(__CUDACC__) || __has_include(<cuda_runtime_api.h>)
+    #include <cuda_runtime_api.h>
+    #define FIBB_ARRAY_WRAPPER_GPU(name) cuda##name
+#endif
+
+namespace fibb
+{
+    /* MEMORY SPACES */
+    // Where the elements of a wrapped array live, which decides who can access them and how they are copied
+    struct Host_Space {};    // pageable host memory, host access only
+    struct Pinned_Space {};  // page locked host memory, which async copies need to overlap with compute
+    struct Device_Space {};  // device global memory, device access only
+    struct Managed_Space {}; // unified memory, migrated on demand between host and device
+
+    template <typename Space>
+    inline constexpr bool is_host_accessible_v = !std::is_same_v<Space, Device_Space>;
+
+    // pinned memory is mapped into the device address space on all platforms with unified addressing
+    template <typename Space>
+    inline constexpr bool is_device_accessible_v = !std::is_same_v<Space, Host_Space>;
+
+    /* A Space_Array_Wrapper is an Array_Wrapper over memory in the given space. It is a handle rather
+       than a container: it can be passed to kernels and copied between spaces with copy_async(), and
+       view() returns the Array_Wrapper for the elements on the side which can access them. Kernels
+       can also take Array_Wrappers directly, since their construction, element access, iterators and
+       sub-views work in device code.
+
+           __global__ void scale(fibb::Device_Array_Wrapper<float> samples, float gain)
+           {
+               auto view = samples.view();
+               for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < view.size(); i += gridDim.x * blockDim.x)
+               {
+                   view[i] *= gain;
+               }
+           } */
+
+    template <typename T, size_t N, typename Space>
+    class Space_Array_Wrapper : private detail::Extent<N>
+    {
+        private:
+            using extent_type = detail::Extent<N>;
+
+        public:
+            /* TYPES */
+            using value_type = std::remove_cv_t<T>;
+            using size_type = size_t;
+            using pointer = T*;
+            using view_type = Array_Wrapper<T, N>;
+            using memory_space = Space;
+
+            static constexpr size_type extent = N;
+
+            /* CONSTRUCTORS */
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr explicit Space_Array_Wrapper(pointer array_) noexcept // size known at compile time
+                : extent_type(N), m_array(array_)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Space_Array_Wrapper(pointer array_, size_type size_) noexcept
+                : extent_type(size_), m_array(array_)
+            {}
+
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr explicit Space_Array_Wrapper(view_type view_) noexcept
+                : extent_type(view_.size()), m_array(view_.data())
+            {}
+
+            // to a dynamic or const wrapper in the same space
+            template <typename U, size_t M, std::enable_if_t<(N == dynamic_extent || N == M)
+                && std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Space_Array_Wrapper(const Space_Array_Wrapper<U, M, Space>& other) noexcept
+                : extent_type(other.size()), m_array(other.data())
+            {}
+
+            /* CAPACITY */
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr size_type size() const noexcept { return extent_type::size(); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr size_type size_bytes() const noexcept { return size() * sizeof(T); }
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr bool empty() const noexcept { return size() == 0; }
+
+            /* ACCESS */
+            // like a pointer, a const handle still refers to writable elements
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr pointer data() const noexcept { return m_array; }
+
+            // the elements may only be accessed through the view where the space is accessible, see
+            // is_host_accessible_v and is_device_accessible_v
+            FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr view_type view() const noexcept
+            {
+                if constexpr (N == dynamic_extent) { return view_type(m_array, size()); }
+                else
+                {
+                    pointer first = m_array;
+                    return view_type(first);
+                }
+            }
+
+        private:
+            pointer m_array;
+    };
+
+    template <typename T, size_t N = dynamic_extent>
+    using Device_Array_Wrapper = Space_Array_Wrapper<T, N, Device_Space>;
+
+    template <typename T, size_t N = dynamic_extent>
+    using Pinned_Array_Wrapper = Space_Array_Wrapper<T, N, Pinned_Space>;
+
+    template <typename T, size_t N = dynamic_extent>
+    using Managed_Array_Wrapper = Space_Array_Wrapper<T, N, Managed_Space>;
+
+    // tags an existing wrapper with the space its memory is in, e.g. in_space<Device_Space>(wrapper)
+    template <typename Space, typename T, size_t N>
+    FIBB_ARRAY_WRAPPER_HOST_DEVICE constexpr Space_Array_Wrapper<T, N, Space> in_space(Array_Wrapper<T, N> array_) noexcept
+    {
+        return Space_Array_Wrapper<T, N, Space>(array_);
+    }
+
+#if defined(FIBB_ARRAY_WRAPPER_GPU)
+    using Gpu_Stream = FIBB_ARRAY_WRAPPER_GPU(Stream_t);
+
+    namespace detail
+    {
+        [[noreturn]] FIBB_ARRAY_WRAPPER_COLD inline void raise_gpu_error(const char* what, FIBB_ARRAY_WRAPPER_GPU(Error_t) error)
+        {
+            throw std::runtime_error(std::string(what) + ": " + FIBB_ARRAY_WRAPPER_GPU(GetErrorString)(error));
+        }
+
+        // the runtime infers the direction itself for managed memory
+        template <typename Src_Space, typename Dest_Space>
+        constexpr FIBB_ARRAY_WRAPPER_GPU(MemcpyKind) copy_kind() noexcept
+        {
+            constexpr bool from_device = std::is_same_v<Src_Space, Device_Space>;
+            constexpr bool to_device = std::is_same_v<Dest_Space, Device_Space>;
+
+            if constexpr (std::is_same_v<Src_Space, Managed_Space> || std::is_same_v<Dest_Space, Managed_Space>)
+            {
+                return FIBB_ARRAY_WRAPPER_GPU(MemcpyDefault);
+            }
+            else if constexpr (from_device && to_device) { return FIBB_ARRAY_WRAPPER_GPU(MemcpyDeviceToDevice); }
+            else if constexpr (from_device) { return FIBB_ARRAY_WRAPPER_GPU(MemcpyDeviceToHost); }
+            else if constexpr (to_device) { return FIBB_ARRAY_WRAPPER_GPU(MemcpyHostToDevice); }
+            else { return FIBB_ARRAY_WRAPPER_GPU(MemcpyHostToHost); }
+        }
+    }
+
+    /* ASYNC COPIES */
+    // Queues a copy of src into dest on stream and returns at once, so that the transfer overlaps with
+    // host work and with kernels in other streams; synchronize the stream before using the result. The
+    // direction follows from the spaces. A pageable Host_Space side makes the runtime stage the copy
+    // through a bounce buffer, so it only overlaps with Pinned_Space. Sizes must match as they must
+    // for assignment, and a failing call throws std::runtime_error.
+    template <typename T, size_t N, typename Dest_Space, typename U, size_t M, typename Src_Space>
+    inline void copy_async(Space_Array_Wrapper<T, N, Dest_Space> dest, Space_Array_Wrapper<U, M, Src_Space> src, Gpu_Stream stream)
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<U>, T>, "Destination must have the same, writable element type");
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be copied between spaces");
+
+        if constexpr (N != dynamic_extent && M != dynamic_extent)
+        {
+            static_assert(N == M, "Array_Wrappers must have the same size");
+        }
+        else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(dest.size() != src.size()))
+        {
+            detail::raise_length_error(dest.size(), src.size());
+        }
+
+        const auto error = FIBB_ARRAY_WRAPPER_GPU(MemcpyAsync)(dest.data(), src.data(), dest.size_bytes(),
+            detail::copy_kind<Src_Space, Dest_Space>(), stream);
+        if (error != FIBB_ARRAY_WRAPPER_GPU(Success)) { detail::raise_gpu_error("MemcpyAsync", error); }
+    }
+
+    // host to device, from a plain wrapper over pageable memory or from pinned or managed memory
+    template <typename T, size_t N, typename U, size_t M>
+    inline void copy_to_device(Device_Array_Wrapper<T, N> dest, Array_Wrapper<U, M> src, Gpu_Stream stream)
+    {
+        copy_async(dest, in_space<Host_Space>(src), stream);
+    }
+
+    template <typename T, size_t N, typename U, size_t M, typename Src_Space>
+    inline void copy_to_device(Device_Array_Wrapper<T, N> dest, Space_Array_Wrapper<U, M, Src_Space> src, Gpu_Stream stream)
+    {
+        static_assert(is_host_accessible_v<Src_Space>, "Source must be in host memory");
+        copy_async(dest, src, stream);
+    }
+
+    // device to host, into a plain wrapper over pageable memory or into pinned or managed memory
+    template <typename T, size_t N, typename U, size_t M>
+    inline void copy_to_host(Array_Wrapper<T, N> dest, Device_Array_Wrapper<U, M> src, Gpu_Stream stream)
+    {
+        copy_async(in_space<Host_Space>(dest), src, stream);
+    }
+
+    template <typename T, size_t N, typename Dest_Space, typename U, size_t M>
+    inline void copy_to_host(Space_Array_Wrapper<T, N, Dest_Space> dest, Device_Array_Wrapper<U, M> src, Gpu_Stream stream)
+    {
+        static_assert(is_host_accessible_v<Dest_Space>, "Destination must be in host memory");
+        copy_async(dest, src, stream);
+    }
+#endif
+}
+
+#endif
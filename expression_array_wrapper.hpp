@@ -0,0 +1,237 @@
+#ifndef FIBB_EXPRESSION_ARRAY_WRAPPER
+#define FIBB_EXPRESSION_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <cmath>
+#include <tuple>
+
+namespace fibb
+{
+    template <typename Op, typename... Operands>
+    class Array_Expression;
+
+    template <typename Op, typename... Operands>
+    struct is_array_expression<Array_Expression<Op, Operands...>> : std::true_type {};
+
+    namespace detail
+    {
+        /* EXPRESSION OPERANDS */
+        // Wrapped arrays are held as a pointer and size rather than as an Array_Wrapper, so that evaluating
+        // an element is a plain load without the access policy of operator[].
+
+        template <typename T, size_t N>
+        class Array_Leaf : private Extent<N>
+        {
+            public:
+                static constexpr size_t extent = N;
+                static constexpr bool is_scalar = false;
+
+                constexpr explicit Array_Leaf(const Array_Wrapper<T, N>& array_) noexcept
+                    : Extent<N>(array_.size()), m_data(array_.data()) {}
+
+                constexpr const T& operator[](size_t pos) const noexcept { return m_data[pos]; }
+                constexpr size_t size() const noexcept { return Extent<N>::size(); }
+
+            private:
+                const T* m_data;
+        };
+
+        // a scalar is broadcast to every element
+        template <typename T>
+        class Scalar_Leaf
+        {
+            public:
+                static constexpr size_t extent = dynamic_extent;
+                static constexpr bool is_scalar = true;
+
+                constexpr explicit Scalar_Leaf(const T& value_) noexcept : m_value(value_) {}
+
+                constexpr const T& operator[](size_t) const noexcept { return m_value; }
+                constexpr size_t size() const noexcept { return dynamic_extent; }
+
+            private:
+                T m_value;
+        };
+
+        // matches Array_Wrapper and the types derived from it
+        template <typename T, size_t N>
+        Array_Leaf<T, N> as_leaf(const Array_Wrapper<T, N>&);
+
+        template <typename T, typename = void>
+        struct is_wrapper_operand : std::false_type {};
+
+        template <typename T>
+        struct is_wrapper_operand<T, std::void_t<decltype(as_leaf(std::declval<const T&>()))>> : std::true_type {};
+
+        template <typename T>
+        inline constexpr bool is_array_operand_v = is_wrapper_operand<T>::value || is_array_expression<T>::value;
+
+        template <typename T>
+        inline constexpr bool is_operand_v = is_array_operand_v<T> || std::is_arithmetic_v<T>;
+
+        template <typename T>
+        constexpr auto make_operand(const T& operand) noexcept
+        {
+            if constexpr (is_array_expression<T>::value) { return operand; }
+            else if constexpr (is_wrapper_operand<T>::value) { return decltype(as_leaf(operand))(operand); }
+            else { return Scalar_Leaf<T>(operand); }
+        }
+
+        template <typename T>
+        using operand_t = decltype(make_operand(std::declval<const T&>()));
+
+        // operators take part when at least one side is an array and the others are arrays or scalars
+        template <typename... Ts>
+        using enable_expression_t = std::enable_if_t<(is_operand_v<Ts> && ...) && (is_array_operand_v<Ts> || ...), int>;
+
+        template <typename... Operands>
+        constexpr size_t common_extent() noexcept
+        {
+            size_t extent = dynamic_extent;
+            ((extent = extent != dynamic_extent ? extent : Operands::extent), ...);
+            return extent;
+        }
+
+        /* ELEMENT OPERATIONS */
+        struct Plus { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a + b; } };
+        struct Minus { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a - b; } };
+        struct Multiplies { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a * b; } };
+        struct Divides { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a / b; } };
+        struct Negate { template <typename A> constexpr auto operator()(const A& a) const { return -a; } };
+
+        // b < a as in std::min so that the first argument wins ties
+        struct Min { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return b < a ? b : a; } };
+        struct Max { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a < b ? b : a; } };
+
+        struct Abs
+        {
+            template <typename A>
+            constexpr auto operator()(const A& a) const
+            {
+                if constexpr (std::is_floating_point_v<A>) { return std::abs(a); }
+                else if constexpr (std::is_unsigned_v<A>) { return a; }
+                else { return a < 0 ? -a : a; }
+            }
+        };
+
+        // std::fma is only used where it is as fast as a multiply and add since it is otherwise a library
+        // call which stops vectorization. The compiler may still contract a * b + c.
+        struct Fma
+        {
+            template <typename A, typename B, typename C>
+            constexpr auto operator()(const A& a, const B& b, const C& c) const
+            {
+                // both branches compute in the common type, std::fma would otherwise promote mixed arguments
+                // to double and the fallback would mix conversions, which -Wconversion flags
+                using R = std::common_type_t<A, B, C>;
+#if defined(FP_FAST_FMA) && defined(FP_FAST_FMAF)
+                if constexpr (std::is_floating_point_v<R>)
+                {
+                    if (!is_constant_evaluated()) { return static_cast<R>(std::fma(static_cast<R>(a), static_cast<R>(b), static_cast<R>(c))); }
+                }
+#endif
+                return static_cast<R>(static_cast<R>(a) * static_cast<R>(b) + static_cast<R>(c));
+            }
+        };
+    }
+
+    /* An Array_Expression is a lazily evaluated element-wise operation over Array_Wrappers, scalars and other
+       expressions. Nothing is computed until the expression is assigned to an Array_Wrapper, which then runs
+       the whole formula in one pass without temporaries. Expressions hold views of their arrays, so they
+       must not outlive them. Mixing fixed sizes is checked at compile time, dynamic ones on construction. */
+
+    template <typename Op, typename... Operands>
+    class Array_Expression
+    {
+        public:
+            using value_type = std::decay_t<decltype(Op()(std::declval<const Operands&>()[0]...))>;
+            using size_type = size_t;
+
+            static constexpr size_type extent = detail::common_extent<Operands...>();
+            static constexpr bool is_scalar = false;
+
+            constexpr explicit Array_Expression(const Operands&... operands_)
+                : m_operands(operands_...)
+            {
+                static_assert(((Operands::extent == dynamic_extent || Operands::extent == extent) && ...),
+                    "Array_Wrappers in an expression must have the same size");
+
+                if constexpr (extent == dynamic_extent || ((Operands::extent == dynamic_extent && !Operands::is_scalar) || ...))
+                {
+                    const size_type expected = size();
+                    const auto check = [expected] (const auto& operand)
+                    {
+                        if (!operand.is_scalar && FIBB_ARRAY_WRAPPER_CHECK_FAILED(operand.size() != expected))
+                        {
+                            detail::raise_length_error(expected, operand.size());
+                        }
+                    };
+                    (check(operands_), ...);
+                }
+            }
+
+            constexpr value_type operator[](size_type pos) const
+            {
+                return std::apply([pos] (const Operands&... operands) { return value_type(Op()(operands[pos]...)); }, m_operands);
+            }
+
+            constexpr size_type size() const noexcept
+            {
+                if constexpr (extent != dynamic_extent) { return extent; }
+                else
+                {
+                    return std::apply([] (const Operands&... operands)
+                    {
+                        size_type result = dynamic_extent;
+                        ((result = result != dynamic_extent ? result : operands.size()), ...);
+                        return result;
+                    }, m_operands);
+                }
+            }
+
+        private:
+            std::tuple<Operands...> m_operands;
+    };
+
+    namespace detail
+    {
+        template <typename Op, typename... Ts>
+        constexpr auto make_expression(const Ts&... operands)
+        {
+            return Array_Expression<Op, operand_t<Ts>...>(make_operand(operands)...);
+        }
+    }
+
+    /* OPERATORS */
+    template <typename A, typename B, detail::enable_expression_t<A, B> = 0>
+    constexpr auto operator+(const A& a, const B& b) { return detail::make_expression<detail::Plus>(a, b); }
+
+    template <typename A, typename B, detail::enable_expression_t<A, B> = 0>
+    constexpr auto operator-(const A& a, const B& b) { return detail::make_expression<detail::Minus>(a, b); }
+
+    template <typename A, typename B, detail::enable_expression_t<A, B> = 0>
+    constexpr auto operator*(const A& a, const B& b) { return detail::make_expression<detail::Multiplies>(a, b); }
+
+    template <typename A, typename B, detail::enable_expression_t<A, B> = 0>
+    constexpr auto operator/(const A& a, const B& b) { return detail::make_expression<detail::Divides>(a, b); }
+
+    template <typename A, detail::enable_expression_t<A> = 0>
+    constexpr auto operator-(const A& a) { return detail::make_expression<detail::Negate>(a); }
+
+    /* FUNCTIONS */
+    // a * b + c
+    template <typename A, typename B, typename C, detail::enable_expression_t<A, B, C> = 0>
+    constexpr auto fma(const A& a, const B& b, const C& c) { return detail::make_expression<detail::Fma>(a, b, c); }
+
+    template <typename A, typename B, detail::enable_expression_t<A, B> = 0>
+    constexpr auto min(const A& a, const B& b) { return detail::make_expression<detail::Min>(a, b); }
+
+    template <typename A, typename B, detail::enable_expression_t<A, B> = 0>
+    constexpr auto max(const A& a, const B& b) { return detail::make_expression<detail::Max>(a, b); }
+
+    template <typename A, detail::enable_expression_t<A> = 0>
+    constexpr auto abs(const A& a) { return detail::make_expression<detail::Abs>(a); }
+}
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef FIBB_MAPPED_ARRAY_WRAPPER
+#define FIBB_MAPPED_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace fibb
+{
+    /* How a Mapped_File may be accessed:
+       Read_Only     - the pages can only be read, views need const elements
+       Read_Write    - writes go to the file and are visible to other mappings of it
+       Copy_On_Write - writes go to private copies of the touched pages, the file is left alone */
+
+    enum class Map_Mode { Read_Only, Read_Write, Copy_On_Write };
+
+    /* Hints about how the mapping will be used, they may be combined with |. They are best effort and
+       silently ignored where the platform has no equivalent:
+       Sequential - read ahead aggressively and drop pages behind the reader
+       Random     - don't read ahead
+       Will_Need  - start reading the whole range in the background
+       Huge_Pages - back the mapping with transparent huge pages, Linux only */
+
+    enum class Map_Advice : unsigned { Normal = 0, Sequential = 1, Random = 2, Will_Need = 4, Huge_Pages = 8 };
+
+    constexpr Map_Advice operator|(Map_Advice a, Map_Advice b) noexcept
+    {
+        return static_cast<Map_Advice>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+    }
+
+    constexpr bool operator&(Map_Advice a, Map_Advice b) noexcept
+    {
+        return (static_cast<unsigned>(a) & static_cast<unsigned>(b)) != 0;
+    }
+
+    /* A Mapped_File maps a file, or a byte range of it, into memory and unmaps it again on destruction.
+       view() then wraps the mapped bytes, so tables stored on disk can be used in place: pages are read
+       on first touch, and only the touched ones take up memory. Views don't own the mapping and must not
+       outlive the Mapped_File, which is move only.
+
+           fibb::Mapped_File file("table.bin", fibb::Map_Mode::Read_Only, fibb::Map_Advice::Will_Need);
+           fibb::Array_Wrapper<const float, 4096> table = file.view<const float, 4096>();
+
+       Failing to open or map the file throws std::system_error. The file's size comes from outside the
+       program, so ranges which don't fit in it and views which don't fit in the mapping or are misaligned
+       for T are always rejected, even when checks are disabled. The check policy only decides how the
+       failure is reported. */
+
+    class Mapped_File
+    {
+        public:
+            /* TYPES */
+            using size_type = size_t;
+
+            // maps everything from the offset to the end of the file
+            static constexpr size_type to_end = static_cast<size_type>(-1);
+
+            /* CONSTRUCTORS */
+            Mapped_File() noexcept = default;
+
+            explicit Mapped_File(const std::string& path_, Map_Mode mode_ = Map_Mode::Read_Only,
+                Map_Advice advice_ = Map_Advice::Normal, size_type offset_ = 0, size_type length_ = to_end)
+                : m_mode(mode_)
+            {
+                map(path_, advice_, offset_, length_);
+            }
+
+            Mapped_File(Mapped_File&& other) noexcept { swap(other); }
+
+            Mapped_File& operator=(Mapped_File&& other) noexcept
+            {
+                Mapped_File(std::move(other)).swap(*this);
+                return *this;
+            }
+
+            Mapped_File(const Mapped_File&) = delete;
+            Mapped_File& operator=(const Mapped_File&) = delete;
+
+            ~Mapped_File() { unmap(); }
+
+            void swap(Mapped_File& other) noexcept
+            {
+                std::swap(m_mapping, other.m_mapping);
+                std::swap(m_mapped_size, other.m_mapped_size);
+                std::swap(m_data, other.m_data);
+                std::swap(m_size, other.m_size);
+                std::swap(m_mode, other.m_mode);
+            }
+
+            /* VIEWS */
+            // N elements of T starting byte_offset bytes into the mapping
+            template <typename T, size_t N = dynamic_extent, std::enable_if_t<N != dynamic_extent, int> = 0>
+            Array_Wrapper<T, N> view(size_type byte_offset = 0) const
+            {
+                T* first = checked_view<T>(byte_offset, N);
+                return Array_Wrapper<T, N>(first);
+            }
+
+            // count elements of T starting byte_offset bytes into the mapping, by default as many as fit
+            template <typename T, size_t N = dynamic_extent, std::enable_if_t<N == dynamic_extent, int> = 0>
+            Array_Wrapper<T, N> view(size_type byte_offset = 0, size_type count = to_end) const
+            {
+                if (count == to_end && byte_offset <= m_size) { count = (m_size - byte_offset) / sizeof(T); }
+                return Array_Wrapper<T, N>(checked_view<T>(byte_offset, count), count);
+            }
+
+            /* OPERATIONS */
+            // applies further hints to the whole mapping
+            void advise(Map_Advice advice_) noexcept
+            {
+                if (m_mapping == nullptr) { return; }
+#if defined(_WIN32)
+    #if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+                if (advice_ & Map_Advice::Will_Need)
+                {
+                    WIN32_MEMORY_RANGE_ENTRY range{m_mapping, m_mapped_size};
+                    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+                }
+    #endif
+#else
+                if (advice_ & Map_Advice::Sequential) { madvise(m_mapping, m_mapped_size, MADV_SEQUENTIAL); }
+                if (advice_ & Map_Advice::Random) { madvise(m_mapping, m_mapped_size, MADV_RANDOM); }
+                if (advice_ & Map_Advice::Will_Need) { madvise(m_mapping, m_mapped_size, MADV_WILLNEED); }
+    #if defined(MADV_HUGEPAGE)
+                if (advice_ & Map_Advice::Huge_Pages) { madvise(m_mapping, m_mapped_size, MADV_HUGEPAGE); }
+    #endif
+#endif
+                static_cast<void>(advice_);
+            }
+
+            // writes modified pages of a Read_Write mapping back to the file
+            void flush()
+            {
+                if (m_mapping == nullptr || m_mode != Map_Mode::Read_Write) { return; }
+#if defined(_WIN32)
+                if (!FlushViewOfFile(m_mapping, m_mapped_size)) { raise_system_error("FlushViewOfFile"); }
+#else
+                if (msync(m_mapping, m_mapped_size, MS_SYNC) != 0) { raise_system_error("msync"); }
+#endif
+            }
+
+            /* CAPACITY */
+            size_type size() const noexcept { return m_size; }
+            bool empty() const noexcept { return m_size == 0; }
+
+            /* ACCESS */
+            Map_Mode mode() const noexcept { return m_mode; }
+            unsigned char* data() noexcept { return m_data; }
+            const unsigned char* data() const noexcept { return m_data; }
+
+        private:
+            void* m_mapping = nullptr;
+            size_type m_mapped_size = 0; // from the page boundary before the offset
+            unsigned char* m_data = nullptr;
+            size_type m_size = 0;
+            Map_Mode m_mode = Map_Mode::Read_Only;
+
+            [[noreturn]] FIBB_ARRAY_WRAPPER_COLD static void raise_system_error(const std::string& what)
+            {
+#if defined(_WIN32)
+                throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+                throw std::system_error(errno, std::generic_category(), what);
+#endif
+            }
+
+            // the mapped length of a file of file_size bytes, offset and length are checked against it
+            static size_type mapped_length(size_type file_size, size_type offset_, size_type length_)
+            {
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(offset_ > file_size)) { detail::raise_range_error(offset_); }
+                if (length_ == to_end) { return file_size - offset_; }
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(length_ > file_size - offset_))
+                {
+                    detail::raise_length_error(file_size - offset_, length_);
+                }
+                return length_;
+            }
+
+            template <typename T>
+            T* checked_view(size_type byte_offset, size_type count) const
+            {
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(!std::is_const_v<T> && m_mode == Map_Mode::Read_Only))
+                {
+                    detail::raise_invalid_argument("Mutable view of a read only mapping at: ", byte_offset);
+                }
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(byte_offset > m_size)) { detail::raise_range_error(byte_offset); }
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(count > (m_size - byte_offset) / sizeof(T)))
+                {
+                    detail::raise_length_error((m_size - byte_offset) / sizeof(T), count);
+                }
+
+                unsigned char* first = m_data + byte_offset;
+                const auto address = reinterpret_cast<std::uintptr_t>(first);
+                if (FIBB_ARRAY_WRAPPER_UNLIKELY(address % alignof(T) != 0))
+                {
+                    detail::raise_invalid_argument("Misaligned view at: ", byte_offset);
+                }
+                return reinterpret_cast<T*>(first);
+            }
+
+#if defined(_WIN32)
+            void map(const std::string& path_, Map_Advice advice_, size_type offset_, size_type length_)
+            {
+                DWORD flags = FILE_ATTRIBUTE_NORMAL;
+                if (advice_ & Map_Advice::Sequential) { flags |= FILE_FLAG_SEQUENTIAL_SCAN; }
+                if (advice_ & Map_Advice::Random) { flags |= FILE_FLAG_RANDOM_ACCESS; }
+
+                const DWORD access = m_mode == Map_Mode::Read_Write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+                HANDLE file = CreateFileA(path_.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                    OPEN_EXISTING, flags, nullptr);
+                if (file == INVALID_HANDLE_VALUE) { raise_system_error("CreateFile " + path_); }
+
+                LARGE_INTEGER file_size;
+                if (!GetFileSizeEx(file, &file_size))
+                {
+                    CloseHandle(file);
+                    raise_system_error("GetFileSizeEx " + path_);
+                }
+
+                try { m_size = mapped_length(static_cast<size_type>(file_size.QuadPart), offset_, length_); }
+                catch (...)
+                {
+                    CloseHandle(file);
+                    throw;
+                }
+                if (m_size == 0)
+                {
+                    CloseHandle(file);
+                    return;
+                }
+
+                const DWORD protect = m_mode == Map_Mode::Read_Only ? PAGE_READONLY
+                    : m_mode == Map_Mode::Read_Write ? PAGE_READWRITE : PAGE_WRITECOPY;
+                HANDLE mapping = CreateFileMappingA(file, nullptr, protect, 0, 0, nullptr);
+                CloseHandle(file);
+                if (mapping == nullptr) { raise_system_error("CreateFileMapping " + path_); }
+
+                // views have to start on the allocation granularity rather than on a page
+                SYSTEM_INFO info;
+                GetSystemInfo(&info);
+                const size_type base = offset_ / info.dwAllocationGranularity * info.dwAllocationGranularity;
+                m_mapped_size = m_size + (offset_ - base);
+
+                const DWORD view_access = m_mode == Map_Mode::Read_Only ? FILE_MAP_READ
+                    : m_mode == Map_Mode::Read_Write ? FILE_MAP_WRITE : FILE_MAP_COPY;
+                m_mapping = MapViewOfFile(mapping, view_access, static_cast<DWORD>(static_cast<std::uint64_t>(base) >> 32),
+                    static_cast<DWORD>(base), m_mapped_size);
+                CloseHandle(mapping); // the view keeps the mapping alive
+                if (m_mapping == nullptr)
+                {
+                    m_mapped_size = 0;
+                    m_size = 0;
+                    raise_system_error("MapViewOfFile " + path_);
+                }
+
+                m_data = static_cast<unsigned char*>(m_mapping) + (offset_ - base);
+                advise(advice_);
+            }
+
+            void unmap() noexcept
+            {
+                if (m_mapping != nullptr) { UnmapViewOfFile(m_mapping); }
+            }
+#else
+            void map(const std::string& path_, Map_Advice advice_, size_type offset_, size_type length_)
+            {
+                const int fd = ::open(path_.c_str(), (m_mode == Map_Mode::Read_Write ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+                if (fd < 0) { raise_system_error("open " + path_); }
+
+                struct stat status;
+                if (::fstat(fd, &status) != 0)
+                {
+                    const int error = errno;
+                    ::close(fd);
+                    errno = error;
+                    raise_system_error("fstat " + path_);
+                }
+
+                try { m_size = mapped_length(static_cast<size_type>(status.st_size), offset_, length_); }
+                catch (...)
+                {
+                    ::close(fd);
+                    throw;
+                }
+                if (m_size == 0)
+                {
+                    ::close(fd);
+                    return;
+                }
+
+                const size_type page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+                const size_type base = offset_ / page * page;
+                m_mapped_size = m_size + (offset_ - base);
+
+                const int protection = m_mode == Map_Mode::Read_Only ? PROT_READ : PROT_READ | PROT_WRITE;
+                const int flags = m_mode == Map_Mode::Copy_On_Write ? MAP_PRIVATE : MAP_SHARED;
+                void* mapping = ::mmap(nullptr, m_mapped_size, protection, flags, fd, static_cast<off_t>(base));
+                const int error = errno;
+                ::close(fd); // the mapping keeps the file open
+                if (mapping == MAP_FAILED)
+                {
+                    m_mapped_size = 0;
+                    m_size = 0;
+                    errno = error;
+                    raise_system_error("mmap " + path_);
+                }
+
+                m_mapping = mapping;
+                m_data = static_cast<unsigned char*>(m_mapping) + (offset_ - base);
+                advise(advice_);
+            }
+
+            void unmap() noexcept
+            {
+                if (m_mapping != nullptr) { ::munmap(m_mapping, m_mapped_size); }
+            }
+#endif
+    };
+
+    inline void swap(Mapped_File& a, Mapped_File& b) noexcept
+    {
+        a.swap(b);
+    }
+}
+
+#endif
@@ -0,0 +1,411 @@
+#ifndef FIBB_MULTI_ARRAY_WRAPPER
+#define FIBB_MULTI_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+#include "strided_array_wrapper.hpp"
+
+#include <array>
+#include <utility>
+
+namespace fibb
+{
+    template <typename T, typename Layout, size_t... Extents>
+    class Basic_Multi_Array_Wrapper;
+
+    /* LAYOUTS
+       A layout maps a multi-dimensional index to an offset into the underlying storage. Each layout
+       provides a mapping template which exposes the stride in elements of every dimension. The row
+       and column major strides are compile time constants so index calculations fold away entirely. */
+
+    namespace detail
+    {
+        template <size_t... Extents>
+        constexpr std::array<size_t, sizeof...(Extents)> row_major_strides() noexcept
+        {
+            constexpr std::array<size_t, sizeof...(Extents)> extents = {Extents...};
+            std::array<size_t, sizeof...(Extents)> strides = {};
+            size_t stride = 1;
+            for (size_t r = extents.size(); r-- > 0;)
+            {
+                strides[r] = stride;
+                stride *= extents[r];
+            }
+            return strides;
+        }
+
+        template <size_t... Extents>
+        constexpr std::array<size_t, sizeof...(Extents)> column_major_strides() noexcept
+        {
+            constexpr std::array<size_t, sizeof...(Extents)> extents = {Extents...};
+            std::array<size_t, sizeof...(Extents)> strides = {};
+            size_t stride = 1;
+            for (size_t r = 0; r < extents.size(); ++r)
+            {
+                strides[r] = stride;
+                stride *= extents[r];
+            }
+            return strides;
+        }
+
+        // T[E0][E1]...[En]
+        template <typename T, size_t... Extents>
+        struct nested_array;
+
+        template <typename T>
+        struct nested_array<T> { using type = T; };
+
+        template <typename T, size_t First, size_t... Rest>
+        struct nested_array<T, First, Rest...> { using type = typename nested_array<T, Rest...>::type[First]; };
+
+        template <typename T, size_t... Extents>
+        using nested_array_t = typename nested_array<T, Extents...>::type;
+
+        template <typename T>
+        constexpr auto first_element(T& array_) noexcept
+        {
+            if constexpr (std::is_array_v<std::remove_extent_t<T>>) { return first_element(array_[0]); }
+            else { return &array_[0]; }
+        }
+
+        template <size_t First, size_t... Rest>
+        struct extents_tail
+        {
+            template <typename T, typename Layout>
+            using wrapper = Basic_Multi_Array_Wrapper<T, Layout, Rest...>;
+        };
+    }
+
+    struct Layout_Row_Major
+    {
+        template <size_t... Extents>
+        class mapping
+        {
+            public:
+                static constexpr std::array<size_t, sizeof...(Extents)> strides = detail::row_major_strides<Extents...>();
+                static constexpr bool is_contiguous = true;
+
+                constexpr size_t stride(size_t r) const noexcept { return strides[r]; }
+        };
+    };
+
+    struct Layout_Column_Major
+    {
+        template <size_t... Extents>
+        class mapping
+        {
+            public:
+                static constexpr std::array<size_t, sizeof...(Extents)> strides = detail::column_major_strides<Extents...>();
+                static constexpr bool is_contiguous = true;
+
+                constexpr size_t stride(size_t r) const noexcept { return strides[r]; }
+        };
+    };
+
+    // arbitrary strides in elements given at runtime, e.g. a sub-view or a padded image
+    struct Layout_Strided
+    {
+        template <size_t... Extents>
+        class mapping
+        {
+            public:
+                static constexpr bool is_contiguous = false;
+
+                constexpr mapping(const std::array<size_t, sizeof...(Extents)>& strides_) noexcept : strides(strides_) {}
+
+                constexpr size_t stride(size_t r) const noexcept { return strides[r]; }
+
+                std::array<size_t, sizeof...(Extents)> strides;
+        };
+    };
+
+    /* The Basic_Multi_Array_Wrapper is a non-owning multi-dimensional view over a raw array,
+       similar to std::mdspan. The extents are fixed at compile time and the Layout decides how
+       indices map onto the underlying storage.
+
+       A raw nested array such as T[R][C] is always row major. Other layouts are constructed
+       from a decayed pointer to the first element. Sub-views returned by row(), column() and
+       operator[] refer to the same storage and never copy.
+
+       As with Array_Wrapper the underlying array must exist for the lifetime of the wrapper and
+       assignment copies elements rather than rebinding the view. */
+
+    template <typename T, typename Layout, size_t... Extents>
+    class Basic_Multi_Array_Wrapper
+    {
+        public:
+            /* TYPES */
+            using value_type = T;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using reference = T&;
+            using const_reference = const T&;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using layout_type = Layout;
+            using mapping_type = typename Layout::template mapping<Extents...>;
+            using flat_type = Array_Wrapper<T, (Extents * ...)>;
+
+            /* CONSTRUCTORS */
+            template <typename L = Layout, std::enable_if_t<std::is_same_v<L, Layout_Row_Major>, int> = 0>
+            Basic_Multi_Array_Wrapper(detail::nested_array_t<T, Extents...>& array_) // sized nested array
+                : m_array(detail::first_element(array_)), m_mapping()
+            {}
+
+            template <typename L = Layout, std::enable_if_t<!std::is_same_v<L, Layout_Strided>, int> = 0>
+            Basic_Multi_Array_Wrapper(T*& array_) // decayed array pointer, extents must be known at compile time
+                : m_array(array_), m_mapping()
+            {}
+
+            template <typename L = Layout, std::enable_if_t<std::is_same_v<L, Layout_Strided>, int> = 0>
+            Basic_Multi_Array_Wrapper(T*& array_, const std::array<size_type, sizeof...(Extents)>& strides_)
+                : m_array(array_), m_mapping(strides_)
+            {}
+
+            Basic_Multi_Array_Wrapper(const Basic_Multi_Array_Wrapper&) = default;
+
+            // copy assignment will copy elements into the underlying array
+            Basic_Multi_Array_Wrapper& operator=(const Basic_Multi_Array_Wrapper& other)
+                noexcept(std::is_nothrow_copy_assignable_v<value_type>)
+            {
+                if constexpr (mapping_type::is_contiguous)
+                {
+                    // a named lvalue so that the elements are copied rather than moved
+                    const Array_Wrapper<const T, size()> src = other.flat();
+                    flat() = src;
+                }
+                else if (m_array != other.m_array)
+                {
+                    for_each_index([&] (auto... idx) { (*this)(idx...) = other(idx...); });
+                }
+                return *this;
+            }
+
+            /* COMPARISON */
+            bool operator==(const Basic_Multi_Array_Wrapper& other) const noexcept
+            {
+                if constexpr (mapping_type::is_contiguous)
+                {
+                    return flat() == other.flat();
+                }
+                else
+                {
+                    bool equal = true;
+                    for_each_index([&] (auto... idx) { equal = equal && (*this)(idx...) == other(idx...); });
+                    return equal;
+                }
+            }
+
+            bool operator!=(const Basic_Multi_Array_Wrapper& other) const noexcept { return !(*this == other); }
+
+            void fill(const_reference val)
+            {
+                if constexpr (mapping_type::is_contiguous) { flat().fill(val); }
+                else { for_each_index([&] (auto... idx) { (*this)(idx...) = val; }); }
+            }
+
+            /* CAPACITY */
+            static constexpr size_type rank() noexcept { return sizeof...(Extents); }
+            static constexpr size_type extent(size_type r) noexcept { return s_extents[r]; }
+            static constexpr size_type size() noexcept { return (Extents * ...); }
+            static constexpr bool empty() noexcept { return false; }
+
+            constexpr size_type stride(size_type r) const noexcept { return m_mapping.stride(r); }
+            constexpr const mapping_type& mapping() const noexcept { return m_mapping; }
+
+            /* ELEMENT ACCESS */
+            template <typename... Indices>
+            constexpr reference operator()(Indices... indices) noexcept
+            {
+                static_assert(sizeof...(Indices) == rank());
+                return m_array[offset(std::index_sequence_for<Indices...>(), indices...)];
+            }
+
+            template <typename... Indices>
+            constexpr const_reference operator()(Indices... indices) const noexcept
+            {
+                static_assert(sizeof...(Indices) == rank());
+                return m_array[offset(std::index_sequence_for<Indices...>(), indices...)];
+            }
+
+            // fixes the first index, returns a view of rank - 1 or an element for rank 1
+            // for rank 2 this is the same as row()
+            constexpr decltype(auto) operator[](size_type pos) noexcept
+            {
+                if constexpr (rank() == 1) { return (m_array[pos * m_mapping.stride(0)]); }
+                else { return slice(m_array + pos * m_mapping.stride(0)); }
+            }
+
+            constexpr decltype(auto) operator[](size_type pos) const noexcept
+            {
+                if constexpr (rank() == 1) { return static_cast<const_reference>(m_array[pos * m_mapping.stride(0)]); }
+                else { return slice(const_pointer(m_array + pos * m_mapping.stride(0))); }
+            }
+
+            constexpr pointer data() noexcept { return m_array; }
+            constexpr const_pointer data() const noexcept { return m_array; }
+
+            // row and column major views are contiguous and can be treated as one dimensional
+            template <typename M = mapping_type, std::enable_if_t<M::is_contiguous, int> = 0>
+            flat_type flat() noexcept
+            {
+                return flat_type(m_array);
+            }
+
+            template <typename M = mapping_type, std::enable_if_t<M::is_contiguous, int> = 0>
+            Array_Wrapper<const T, size()> flat() const noexcept
+            {
+                const_pointer array_ = m_array;
+                return Array_Wrapper<const T, size()>(array_);
+            }
+
+            /* SUB-VIEWS */
+            // Contiguous rows and columns are returned as an Array_Wrapper, anything
+            // else as a Strided_Array_Wrapper over the same storage
+            template <size_t R = rank(), std::enable_if_t<R == 2, int> = 0>
+            auto row(size_type pos) noexcept { return line<1>(m_array + pos * m_mapping.stride(0)); }
+
+            template <size_t R = rank(), std::enable_if_t<R == 2, int> = 0>
+            auto row(size_type pos) const noexcept { return line<1>(const_pointer(m_array + pos * m_mapping.stride(0))); }
+
+            template <size_t R = rank(), std::enable_if_t<R == 2, int> = 0>
+            auto column(size_type pos) noexcept { return line<0>(m_array + pos * m_mapping.stride(1)); }
+
+            template <size_t R = rank(), std::enable_if_t<R == 2, int> = 0>
+            auto column(size_type pos) const noexcept { return line<0>(const_pointer(m_array + pos * m_mapping.stride(1))); }
+
+        private:
+            static constexpr std::array<size_type, sizeof...(Extents)> s_extents = {Extents...};
+
+            pointer m_array;
+            mapping_type m_mapping;
+
+            template <size_t... Dims, typename... Indices>
+            constexpr size_type offset(std::index_sequence<Dims...>, Indices... indices) const noexcept
+            {
+                return ((static_cast<size_type>(indices) * m_mapping.stride(Dims)) + ...);
+            }
+
+            // view of the remaining dimensions starting at first, U is T or const T
+            template <typename U>
+            auto slice(U* first) const noexcept
+            {
+                using tail_layout = std::conditional_t<std::is_same_v<Layout, Layout_Row_Major>,
+                    Layout_Row_Major, Layout_Strided>;
+                using tail_type = typename detail::extents_tail<Extents...>::template wrapper<U, tail_layout>;
+
+                if constexpr (rank() == 2)
+                {
+                    return line<1>(first);
+                }
+                else if constexpr (std::is_same_v<tail_layout, Layout_Row_Major>)
+                {
+                    return tail_type(first);
+                }
+                else
+                {
+                    return tail_type(first, tail_strides(std::make_index_sequence<rank() - 1>()));
+                }
+            }
+
+            template <size_t... Dims>
+            constexpr std::array<size_type, sizeof...(Dims)> tail_strides(std::index_sequence<Dims...>) const noexcept
+            {
+                return {m_mapping.stride(Dims + 1)...};
+            }
+
+            // the line running along dimension Dim that starts at first, U is T or const T
+            template <size_t Dim, typename U>
+            auto line(U* first) const noexcept
+            {
+                constexpr size_type length = s_extents[Dim];
+                if constexpr (mapping_type::is_contiguous && mapping_type::strides[Dim] == 1)
+                {
+                    return Array_Wrapper<U, length>(first);
+                }
+                else if constexpr (mapping_type::is_contiguous)
+                {
+                    return Element_Strided_Array_Wrapper<U, length, mapping_type::strides[Dim]>(first);
+                }
+                else
+                {
+                    return Strided_Array_Wrapper<U, length>(first, Element_Stride{m_mapping.stride(Dim)});
+                }
+            }
+
+            // calls fn with every index tuple, last dimension innermost
+            template <size_t Dim = 0, typename Fn, typename... Indices>
+            void for_each_index(Fn&& fn, Indices... indices) const
+            {
+                if constexpr (Dim == rank())
+                {
+                    fn(indices...);
+                }
+                else
+                {
+                    for (size_type i = 0; i < s_extents[Dim]; ++i) { for_each_index<Dim + 1>(fn, indices..., i); }
+                }
+            }
+
+            static_assert(sizeof...(Extents) > 0);
+            static_assert(((Extents > 0) && ...));
+    };
+
+    template <typename T, size_t... Extents>
+    using Multi_Array_Wrapper = Basic_Multi_Array_Wrapper<T, Layout_Row_Major, Extents...>;
+
+    template <typename T, size_t R, size_t C>
+    Basic_Multi_Array_Wrapper(T (&)[R][C]) -> Basic_Multi_Array_Wrapper<T, Layout_Row_Major, R, C>;
+
+    template <typename T, size_t P, size_t R, size_t C>
+    Basic_Multi_Array_Wrapper(T (&)[P][R][C]) -> Basic_Multi_Array_Wrapper<T, Layout_Row_Major, P, R, C>;
+
+    /* The Row_Pointer_Wrapper views R rows of C elements through an array of row pointers,
+       i.e. the T** form of a two dimensional array. Rows need not be contiguous with each
+       other so only rows can be viewed as an Array_Wrapper. */
+
+    template <typename T, size_t R, size_t C>
+    class Row_Pointer_Wrapper
+    {
+        public:
+            /* TYPES */
+            using value_type = T;
+            using pointer = T*;
+            using reference = T&;
+            using const_reference = const T&;
+            using size_type = size_t;
+            using row_type = Array_Wrapper<T, C>;
+
+            /* CONSTRUCTORS */
+            Row_Pointer_Wrapper(T* (&rows_)[R]) // sized array of row pointers
+                : m_rows(rows_)
+            {}
+
+            Row_Pointer_Wrapper(T**& rows_) // decayed row pointers, extents must be known at compile time
+                : m_rows(rows_)
+            {}
+
+            /* CAPACITY */
+            static constexpr size_type rank() noexcept { return 2; }
+            static constexpr size_type extent(size_type r) noexcept { return r == 0 ? R : C; }
+            static constexpr size_type size() noexcept { return R * C; }
+
+            /* ELEMENT ACCESS */
+            constexpr reference operator()(size_type row_, size_type col_) noexcept { return m_rows[row_][col_]; }
+            constexpr const_reference operator()(size_type row_, size_type col_) const noexcept { return m_rows[row_][col_]; }
+
+            row_type operator[](size_type pos) const noexcept { return row(pos); }
+            row_type row(size_type pos) const noexcept { return row_type(m_rows[pos]); }
+
+            void fill(const_reference val)
+            {
+                for (size_type r = 0; r < R; ++r) { row(r).fill(val); }
+            }
+
+            constexpr T** data() const noexcept { return m_rows; }
+
+        private:
+            T** m_rows;
+    };
+}
+
+#endif // FIBB_MULTI_ARRAY_WRAPPER
@@ -0,0 +1,617 @@
+#ifndef FIBB_PACKED_ARRAY_WRAPPER
+#define FIBB_PACKED_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <numeric>
+
+// pack() and unpack() use pdep and pext where BMI2 is available. Define FIBB_ARRAY_WRAPPER_NO_BMI2 on
+// CPUs which implement them slowly in microcode, such as AMD before Zen 3.
+#if !defined(FIBB_ARRAY_WRAPPER_NO_BMI2) && defined(FIBB_ARRAY_WRAPPER_X86_SIMD) \
+    && (defined(__x86_64__) || defined(_M_X64)) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+    #define FIBB_ARRAY_WRAPPER_BMI2
+#endif
+
+namespace fibb
+{
+    namespace detail
+    {
+        // the narrowest unsigned type which holds a Bits wide element
+        template <size_t Bits>
+        using packed_value_t = std::conditional_t<Bits <= 8, std::uint8_t,
+            std::conditional_t<Bits <= 16, std::uint16_t, std::conditional_t<Bits <= 32, std::uint32_t, std::uint64_t>>>;
+
+        inline constexpr size_t word_bits = 64;
+
+        // the low bits set, for any count up to 64
+        constexpr std::uint64_t low_bits(size_t count) noexcept
+        {
+            return count >= word_bits ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+        }
+
+        // x repeated every Bits bits across a word, Bits must divide 64
+        template <size_t Bits>
+        constexpr std::uint64_t replicate_field(std::uint64_t x) noexcept
+        {
+            std::uint64_t result = 0;
+            for (size_t shift = 0; shift < word_bits; shift += Bits) { result |= x << shift; }
+            return result;
+        }
+
+        inline unsigned popcount(std::uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_popcountll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return static_cast<unsigned>(__popcnt64(x));
+#else
+            x = x - ((x >> 1) & 0x5555555555555555);
+            x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0F;
+            return static_cast<unsigned>((x * 0x0101010101010101) >> 56);
+#endif
+        }
+
+        /* ELEMENT ACCESS */
+        // Element i occupies bits i * Bits to i * Bits + Bits - 1 of the buffer, counting from bit 0 of the
+        // first word. Elements cross a word boundary only when Bits doesn't divide 64.
+
+        template <size_t Bits>
+        inline packed_value_t<Bits> packed_get(const std::uint64_t* words, size_t index) noexcept
+        {
+            const size_t bit = index * Bits;
+            const size_t offset = bit % word_bits;
+            std::uint64_t value = words[bit / word_bits] >> offset;
+            if constexpr (word_bits % Bits != 0)
+            {
+                if (offset + Bits > word_bits) { value |= words[bit / word_bits + 1] << (word_bits - offset); }
+            }
+            return static_cast<packed_value_t<Bits>>(value & low_bits(Bits));
+        }
+
+        // bits of value above Bits are dropped
+        template <size_t Bits>
+        inline void packed_set(std::uint64_t* words, size_t index, std::uint64_t value) noexcept
+        {
+            constexpr std::uint64_t mask = low_bits(Bits);
+            const size_t bit = index * Bits;
+            const size_t offset = bit % word_bits;
+            std::uint64_t* word = words + bit / word_bits;
+            value &= mask;
+            *word = (*word & ~(mask << offset)) | (value << offset);
+            if constexpr (word_bits % Bits != 0)
+            {
+                if (offset + Bits > word_bits)
+                {
+                    const size_t shift = word_bits - offset;
+                    word[1] = (word[1] & ~(mask >> shift)) | (value >> shift);
+                }
+            }
+        }
+
+        // assigning to the proxy writes the element, reading it converts to the element value
+        template <size_t Bits>
+        class Packed_Reference
+        {
+            public:
+                using value_type = packed_value_t<Bits>;
+
+                Packed_Reference(std::uint64_t* words_, size_t index_) noexcept : m_words(words_), m_index(index_) {}
+                Packed_Reference(const Packed_Reference&) noexcept = default;
+
+                operator value_type() const noexcept { return packed_get<Bits>(m_words, m_index); }
+
+                const Packed_Reference& operator=(value_type val) const noexcept
+                {
+                    packed_set<Bits>(m_words, m_index, val);
+                    return *this;
+                }
+
+                const Packed_Reference& operator=(const Packed_Reference& other) const noexcept
+                {
+                    return *this = static_cast<value_type>(other);
+                }
+
+                friend void swap(const Packed_Reference& a, const Packed_Reference& b) noexcept
+                {
+                    const value_type tmp = a;
+                    a = static_cast<value_type>(b);
+                    b = tmp;
+                }
+
+            private:
+                std::uint64_t* m_words;
+                size_t m_index;
+        };
+    }
+
+    /* Random access iterator over the elements of a Packed_Array_Wrapper. Dereferencing yields a
+       Packed_Reference proxy, or the value itself when Word is const. */
+
+    template <size_t Bits, typename Word>
+    class Packed_Iterator
+    {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = detail::packed_value_t<Bits>;
+            using difference_type = ptrdiff_t;
+            using pointer = void;
+            using reference = std::conditional_t<std::is_const_v<Word>, value_type, detail::Packed_Reference<Bits>>;
+
+            Packed_Iterator() noexcept : m_words(nullptr), m_index(0) {}
+            Packed_Iterator(Word* words_, size_t index_) noexcept : m_words(words_), m_index(index_) {}
+
+            // iterator to const_iterator
+            template <typename U, std::enable_if_t<std::is_same_v<const U, Word>, int> = 0>
+            Packed_Iterator(const Packed_Iterator<Bits, U>& other) noexcept
+                : m_words(other.words()), m_index(other.index())
+            {}
+
+            reference operator*() const noexcept
+            {
+                if constexpr (std::is_const_v<Word>) { return detail::packed_get<Bits>(m_words, m_index); }
+                else { return reference(m_words, m_index); }
+            }
+
+            reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+            Packed_Iterator& operator++() noexcept { ++m_index; return *this; }
+            Packed_Iterator& operator--() noexcept { --m_index; return *this; }
+            Packed_Iterator operator++(int) noexcept { Packed_Iterator tmp = *this; ++*this; return tmp; }
+            Packed_Iterator operator--(int) noexcept { Packed_Iterator tmp = *this; --*this; return tmp; }
+
+            Packed_Iterator& operator+=(difference_type n) noexcept
+            {
+                m_index = static_cast<size_t>(static_cast<difference_type>(m_index) + n);
+                return *this;
+            }
+
+            Packed_Iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+            friend Packed_Iterator operator+(Packed_Iterator it, difference_type n) noexcept { return it += n; }
+            friend Packed_Iterator operator+(difference_type n, Packed_Iterator it) noexcept { return it += n; }
+            friend Packed_Iterator operator-(Packed_Iterator it, difference_type n) noexcept { return it -= n; }
+
+            friend difference_type operator-(const Packed_Iterator& a, const Packed_Iterator& b) noexcept
+            {
+                return static_cast<difference_type>(a.m_index) - static_cast<difference_type>(b.m_index);
+            }
+
+            // iterators into different wrappers don't compare meaningfully, as with pointers
+            friend bool operator==(const Packed_Iterator& a, const Packed_Iterator& b) noexcept { return a.m_index == b.m_index; }
+            friend bool operator!=(const Packed_Iterator& a, const Packed_Iterator& b) noexcept { return a.m_index != b.m_index; }
+            friend bool operator<(const Packed_Iterator& a, const Packed_Iterator& b) noexcept { return a.m_index < b.m_index; }
+            friend bool operator>(const Packed_Iterator& a, const Packed_Iterator& b) noexcept { return a.m_index > b.m_index; }
+            friend bool operator<=(const Packed_Iterator& a, const Packed_Iterator& b) noexcept { return a.m_index <= b.m_index; }
+            friend bool operator>=(const Packed_Iterator& a, const Packed_Iterator& b) noexcept { return a.m_index >= b.m_index; }
+
+            Word* words() const noexcept { return m_words; }
+            size_t index() const noexcept { return m_index; }
+
+        private:
+            Word* m_words;
+            size_t m_index;
+    };
+
+    /* The Packed_Array_Wrapper views N elements of Bits bits each, packed back to back into a buffer of
+       64 bit words, such as flags or small codes from hardware registers and legacy file formats. Bits
+       can be anything from 1 to 64; with widths which don't divide 64, e.g. 12, elements straddle word
+       boundaries. It offers the same std::array like interface as Array_Wrapper, except that elements
+       are accessed through proxy references which read or write the bits in place. Any values written
+       are truncated to Bits bits.
+
+       Bulk operations work on whole words rather than element by element: fill() stores a repeating
+       pattern, comparisons compare the words, count() is a popcount and count(val) counts matching
+       fields with a few bitwise operations per word. unpack() widens the elements into an Array_Wrapper
+       of unsigned integers and pack() narrows them back, using pdep and pext where BMI2 is available.
+
+       Bits past the last element in its final word are never modified. Word is const std::uint64_t
+       for a read only view. As with Array_Wrapper the buffer must exist for the lifetime of the
+       wrapper and assignment copies elements rather than rebinding the view. */
+
+    template <size_t Bits, size_t N = dynamic_extent, typename Word = std::uint64_t>
+    class Packed_Array_Wrapper : private detail::Extent<N>
+    {
+        private:
+            using extent_type = detail::Extent<N>;
+
+        public:
+            static_assert(Bits >= 1 && Bits <= 64, "Packed elements must be 1 to 64 bits wide");
+            static_assert(std::is_same_v<std::remove_const_t<Word>, std::uint64_t>, "Packed elements are stored in std::uint64_t words");
+
+            /* TYPES */
+            using value_type = detail::packed_value_t<Bits>;
+            using word_type = Word;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using iterator = Packed_Iterator<Bits, Word>;
+            using const_iterator = Packed_Iterator<Bits, const Word>;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+            using reference = typename iterator::reference;
+            using const_reference = value_type;
+
+            static constexpr size_type extent = N;
+            static constexpr size_type bits = Bits;
+
+            // words needed to hold count elements
+            static constexpr size_type words_for(size_type count) noexcept
+            {
+                return (count * Bits + detail::word_bits - 1) / detail::word_bits;
+            }
+
+            /* CONSTRUCTORS */
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            Packed_Array_Wrapper(Word*& words_) noexcept // decayed buffer pointer, size known at compile time
+                : extent_type(N), m_words(words_)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            Packed_Array_Wrapper(Word* words_, size_type size_) noexcept // first word and runtime size
+                : extent_type(size_), m_words(words_)
+            {}
+
+            // a sized buffer, a runtime sized wrapper holds as many elements as fit
+            template <size_t M>
+            Packed_Array_Wrapper(Word (&words_)[M]) noexcept
+                : extent_type(M * detail::word_bits / Bits), m_words(words_)
+            {
+                static_assert(N == dynamic_extent || words_for(N) <= M, "Buffer is too small for N elements");
+            }
+
+            // a wrapped buffer, the length is checked like at() for runtime sizes
+            template <size_t M>
+            Packed_Array_Wrapper(Array_Wrapper<Word, M> words_, size_type size_ = N)
+                : extent_type(size_), m_words(words_.data())
+            {
+                if constexpr (N != dynamic_extent && M != dynamic_extent)
+                {
+                    static_assert(words_for(N) <= M, "Buffer is too small for N elements");
+                }
+                else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(size() == dynamic_extent || words_for(size()) > words_.size()))
+                {
+                    detail::raise_length_error(words_.size(), words_for(size()));
+                }
+            }
+
+            // writable view to read only view
+            template <typename U, std::enable_if_t<std::is_same_v<const U, Word>, int> = 0>
+            Packed_Array_Wrapper(const Packed_Array_Wrapper<Bits, N, U>& other) noexcept
+                : extent_type(other.size()), m_words(other.data())
+            {}
+
+            // copying a wrapper copies the pointer, assigning one copies the elements
+            Packed_Array_Wrapper(const Packed_Array_Wrapper&) = default;
+
+            /* COMPARISON */
+            // equal elements have equal bits, so whole words are compared
+            bool operator==(const Packed_Array_Wrapper& other) const noexcept
+            {
+                if (size() != other.size()) { return false; }
+                const size_type full = full_words();
+                if (full != 0 && std::memcmp(m_words, other.m_words, full * sizeof(std::uint64_t)) != 0) { return false; }
+                return tail_mask() == 0 || ((m_words[full] ^ other.m_words[full]) & tail_mask()) == 0;
+            }
+
+            bool operator!=(const Packed_Array_Wrapper& other) const noexcept { return !(*this == other); }
+
+            bool operator<(const Packed_Array_Wrapper& other) const noexcept
+            {
+                return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+            }
+
+            bool operator>(const Packed_Array_Wrapper& other) const noexcept { return other < *this; }
+            bool operator<=(const Packed_Array_Wrapper& other) const noexcept { return !(other < *this); }
+            bool operator>=(const Packed_Array_Wrapper& other) const noexcept { return !(*this < other); }
+
+            /* ASSIGNMENT */
+            // copy assignment will copy elements into the underlying buffer
+            Packed_Array_Wrapper& operator=(const Packed_Array_Wrapper& other) noexcept(N != dynamic_extent)
+            {
+                static_assert(!std::is_const_v<Word>, "Can't assign to a read only view");
+
+                check_same_size(other.size());
+                if (m_words != other.m_words)
+                {
+                    const size_type full = full_words();
+                    std::memmove(m_words, other.m_words, full * sizeof(std::uint64_t));
+                    if (tail_mask() != 0) { merge_tail(other.m_words[full]); }
+                }
+                return *this;
+            }
+
+            void fill(value_type val) noexcept
+            {
+                static_assert(!std::is_const_v<Word>, "Can't fill a read only view");
+
+                // the bit pattern repeats every Bits / gcd(Bits, 64) words
+                constexpr size_type period = Bits / std::gcd(Bits, detail::word_bits);
+                std::uint64_t pattern[period] = {};
+                for (size_type i = 0; i < period * detail::word_bits / Bits; ++i) { detail::packed_set<Bits>(pattern, i, val); }
+
+                const size_type full = full_words();
+                size_type phase = 0;
+                for (size_type i = 0; i < full; ++i)
+                {
+                    m_words[i] = pattern[phase];
+                    if (++phase == period) { phase = 0; }
+                }
+                merge_tail(pattern[phase]);
+            }
+
+            // swaps the elements, not the pointers
+            void swap(Packed_Array_Wrapper& other) noexcept(N != dynamic_extent)
+            {
+                static_assert(!std::is_const_v<Word>, "Can't swap a read only view");
+
+                check_same_size(other.size());
+                if (m_words != other.m_words)
+                {
+                    const size_type full = full_words();
+                    std::swap_ranges(m_words, m_words + full, other.m_words);
+                    if (tail_mask() != 0)
+                    {
+                        const std::uint64_t tail = m_words[full];
+                        merge_tail(other.m_words[full]);
+                        other.merge_tail(tail);
+                    }
+                }
+            }
+
+            /* BIT COUNTS */
+            // set bits over all elements, for one bit elements the number which are set
+            size_type count() const noexcept
+            {
+                const size_type full = full_words();
+                size_type result = 0;
+                for (size_type i = 0; i < full; ++i) { result += detail::popcount(m_words[i]); }
+                if (tail_mask() != 0) { result += detail::popcount(m_words[full] & tail_mask()); }
+                return result;
+            }
+
+            // elements equal to val
+            size_type count(value_type val) const noexcept
+            {
+                if constexpr (detail::word_bits % Bits == 0)
+                {
+                    // a field of x = word ^ pattern is non-zero iff its top bit is set after adding the
+                    // low bits to themselves, which can't carry into the next field
+                    constexpr std::uint64_t high = detail::replicate_field<Bits>(std::uint64_t(1) << (Bits - 1));
+                    constexpr std::uint64_t low = ~high;
+                    constexpr size_type fields = detail::word_bits / Bits;
+                    const std::uint64_t pattern = detail::replicate_field<Bits>(val & detail::low_bits(Bits));
+                    const auto non_zero = [&] (std::uint64_t word) noexcept
+                    {
+                        const std::uint64_t x = word ^ pattern;
+                        return (((x & low) + low) | x) & high;
+                    };
+
+                    const size_type full = full_words();
+                    size_type result = full * fields;
+                    for (size_type i = 0; i < full; ++i) { result -= detail::popcount(non_zero(m_words[i])); }
+                    if (tail_mask() != 0)
+                    {
+                        result += size() % fields - detail::popcount(non_zero(m_words[full]) & tail_mask());
+                    }
+                    return result;
+                }
+                else
+                {
+                    const value_type target = static_cast<value_type>(val & detail::low_bits(Bits));
+                    size_type result = 0;
+                    for (size_type i = 0; i < size(); ++i) { result += detail::packed_get<Bits>(m_words, i) == target; }
+                    return result;
+                }
+            }
+
+            /* PACK / UNPACK */
+            // widens every element into dest, whose elements are unsigned integers of at least Bits bits
+            template <typename U, size_t M>
+            void unpack(Array_Wrapper<U, M> dest) const
+            {
+                static_assert(std::is_unsigned_v<U> && !std::is_same_v<U, bool> && std::numeric_limits<U>::digits >= Bits,
+                    "Elements unpack into unsigned integers at least Bits wide");
+                check_unpacked_size<M>(dest.size());
+
+                U* out = dest.data();
+                size_type i = 0;
+                if constexpr (detail::word_bits % Bits == 0 && Bits < std::numeric_limits<U>::digits)
+                {
+                    for (const size_type full = full_words(); i / per_word < full; i += per_word)
+                    {
+                        unpack_word(m_words[i / per_word], out + i);
+                    }
+                }
+                for (; i < size(); ++i) { out[i] = detail::packed_get<Bits>(m_words, i); }
+            }
+
+            // narrows every element of src into the buffer, bits of the values above Bits are dropped
+            template <typename U, size_t M>
+            void pack(const Array_Wrapper<U, M>& src)
+            {
+                static_assert(!std::is_const_v<Word>, "Can't pack into a read only view");
+                static_assert(std::is_unsigned_v<std::remove_cv_t<U>> && !std::is_same_v<std::remove_cv_t<U>, bool>,
+                    "Elements pack from unsigned integers");
+                check_unpacked_size<M>(src.size());
+
+                const U* in = src.data();
+                size_type i = 0;
+                if constexpr (detail::word_bits % Bits == 0 && Bits < std::numeric_limits<std::remove_cv_t<U>>::digits)
+                {
+                    for (const size_type full = full_words(); i / per_word < full; i += per_word)
+                    {
+                        m_words[i / per_word] = pack_word(in + i);
+                    }
+                }
+                for (; i < size(); ++i) { detail::packed_set<Bits>(m_words, i, in[i]); }
+            }
+
+            /* ITERATORS */
+            iterator begin() noexcept { return iterator(m_words, 0); }
+            const_iterator begin() const noexcept { return const_iterator(m_words, 0); }
+            const_iterator cbegin() const noexcept { return begin(); }
+
+            iterator end() noexcept { return iterator(m_words, size()); }
+            const_iterator end() const noexcept { return const_iterator(m_words, size()); }
+            const_iterator cend() const noexcept { return end(); }
+
+            reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+            const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+            reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+            const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+            /* CAPACITY */
+            constexpr size_type size() const noexcept { return extent_type::size(); }
+            constexpr size_type max_size() const noexcept { return size(); }
+            constexpr bool empty() const noexcept { return size() == 0; }
+
+            // words the elements occupy, the last one possibly partially
+            constexpr size_type word_count() const noexcept { return words_for(size()); }
+
+            /* ELEMENT ACCESS */
+            reference operator[](size_type pos) noexcept
+            {
+                detail::check_access(pos, size());
+                return begin()[static_cast<difference_type>(pos)];
+            }
+
+            const_reference operator[](size_type pos) const noexcept
+            {
+                detail::check_access(pos, size());
+                return detail::packed_get<Bits>(m_words, pos);
+            }
+
+            reference at(size_type pos)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size())) { detail::raise_range_error(pos); }
+
+                return begin()[static_cast<difference_type>(pos)];
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size())) { detail::raise_range_error(pos); }
+
+                return detail::packed_get<Bits>(m_words, pos);
+            }
+
+            reference front() noexcept { return (*this)[0]; }
+            const_reference front() const noexcept { return (*this)[0]; }
+            reference back() noexcept { return (*this)[size() - 1]; }
+            const_reference back() const noexcept { return (*this)[size() - 1]; }
+
+            // the word buffer
+            Word* data() noexcept { return m_words; }
+            const std::uint64_t* data() const noexcept { return m_words; }
+
+        private:
+            static constexpr size_type per_word = detail::word_bits / Bits;
+
+            Word* m_words;
+
+            // words which hold nothing but elements, and the element bits of the word after them
+            size_type full_words() const noexcept { return size() * Bits / detail::word_bits; }
+            std::uint64_t tail_mask() const noexcept { return detail::low_bits(size() * Bits % detail::word_bits); }
+
+            // overwrites the element bits of the partially used last word
+            void merge_tail(std::uint64_t bits_) noexcept
+            {
+                const std::uint64_t mask = tail_mask();
+                if (mask != 0)
+                {
+                    std::uint64_t& tail = m_words[full_words()];
+                    tail = (tail & ~mask) | (bits_ & mask);
+                }
+            }
+
+            /* WORD KERNELS */
+            // Only used when Bits divides 64, so a word holds per_word whole elements. With BMI2 every
+            // 64 bits of output are one pdep of the elements they hold, which pext reverses.
+
+            template <typename U>
+            static void unpack_word(std::uint64_t word, U* out) noexcept
+            {
+#if defined(FIBB_ARRAY_WRAPPER_BMI2)
+                if constexpr (sizeof(U) < sizeof(std::uint64_t))
+                {
+                    constexpr size_type lanes = sizeof(std::uint64_t) / sizeof(U);
+                    constexpr std::uint64_t deposit = replicate_lanes<U>();
+                    for (size_type j = 0; j < per_word; j += lanes)
+                    {
+                        const std::uint64_t wide = _pdep_u64(word >> (j * Bits), deposit);
+                        std::memcpy(out + j, &wide, sizeof(wide));
+                    }
+                    return;
+                }
+#endif
+                for (size_type j = 0; j < per_word; ++j) { out[j] = static_cast<U>((word >> (j * Bits)) & detail::low_bits(Bits)); }
+            }
+
+            template <typename U>
+            static std::uint64_t pack_word(const U* in) noexcept
+            {
+                std::uint64_t word = 0;
+#if defined(FIBB_ARRAY_WRAPPER_BMI2)
+                if constexpr (sizeof(U) < sizeof(std::uint64_t))
+                {
+                    constexpr size_type lanes = sizeof(std::uint64_t) / sizeof(U);
+                    constexpr std::uint64_t extract = replicate_lanes<U>();
+                    for (size_type j = 0; j < per_word; j += lanes)
+                    {
+                        std::uint64_t wide;
+                        std::memcpy(&wide, in + j, sizeof(wide));
+                        word |= _pext_u64(wide, extract) << (j * Bits);
+                    }
+                    return word;
+                }
+#endif
+                for (size_type j = 0; j < per_word; ++j)
+                {
+                    word |= (static_cast<std::uint64_t>(in[j]) & detail::low_bits(Bits)) << (j * Bits);
+                }
+                return word;
+            }
+
+            // the low Bits of every U sized lane of a word
+            template <typename U>
+            static constexpr std::uint64_t replicate_lanes() noexcept
+            {
+                std::uint64_t result = 0;
+                for (size_type shift = 0; shift < detail::word_bits; shift += 8 * sizeof(U)) { result |= detail::low_bits(Bits) << shift; }
+                return result;
+            }
+
+            template <size_t M>
+            void check_unpacked_size(size_type other_size) const
+            {
+                if constexpr (N != dynamic_extent && M != dynamic_extent)
+                {
+                    static_assert(N == M, "Array_Wrappers must have the same size");
+                }
+                else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(other_size != size()))
+                {
+                    detail::raise_length_error(size(), other_size);
+                }
+            }
+
+            void check_same_size(size_type other_size) const
+            {
+                if constexpr (N == dynamic_extent)
+                {
+                    if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(other_size != size())) { detail::raise_length_error(size(), other_size); }
+                }
+            }
+    };
+
+    template <size_t Bits, size_t N = dynamic_extent>
+    using Const_Packed_Array_Wrapper = Packed_Array_Wrapper<Bits, N, const std::uint64_t>;
+
+    // one bit flags
+    template <size_t N = dynamic_extent>
+    using Bit_Array_Wrapper = Packed_Array_Wrapper<1, N>;
+}
+
+#endif
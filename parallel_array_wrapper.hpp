@@ -0,0 +1,323 @@
+#ifndef FIBB_PARALLEL_ARRAY_WRAPPER
+#define FIBB_PARALLEL_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <atomic>
+#include <exception>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#if __has_include(<execution>)
+    #include <execution>
+#endif
+
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201603L
+    #define FIBB_ARRAY_WRAPPER_EXECUTION_POLICIES
+#endif
+
+// Each worker gets at least this many bytes, smaller wrappers are processed on the calling thread
+#ifndef FIBB_ARRAY_WRAPPER_PARALLEL_CHUNK
+    #define FIBB_ARRAY_WRAPPER_PARALLEL_CHUNK (size_t(1) << 18)
+#endif
+
+namespace fibb
+{
+    /* Executor which runs the tasks on freshly started threads, the calling thread included.
+       Any type with the same bulk() member can be passed instead, e.g. an adaptor for an existing
+       thread pool. bulk(count, fn) must call fn(i) once for every i in [0, count) and return when all
+       calls have finished. An optional concurrency() member tells the algorithms how far to split. */
+
+    class Thread_Executor
+    {
+        public:
+            explicit Thread_Executor(unsigned threads_ = std::thread::hardware_concurrency()) noexcept
+                : m_threads(threads_ == 0 ? 1 : threads_) {}
+
+            unsigned concurrency() const noexcept { return m_threads; }
+
+            // the first exception thrown by a task cancels the remaining tasks and is rethrown here
+            template <typename Fn>
+            void bulk(size_t count, Fn fn) const
+            {
+                std::atomic<size_t> next{0};
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+
+                // threads pull tasks from a shared counter so that uneven chunks balance out
+                auto work = [&] ()
+                {
+                    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+                    {
+                        try { fn(i); }
+                        catch (...)
+                        {
+                            if (!failed.exchange(true)) { error = std::current_exception(); }
+                            next.store(count, std::memory_order_relaxed);
+                        }
+                    }
+                };
+
+                const size_t threads = std::min<size_t>(m_threads, count);
+                std::vector<std::thread> workers;
+                workers.reserve(threads > 0 ? threads - 1 : 0);
+                for (size_t t = 1; t < threads; ++t) { workers.emplace_back(work); }
+                work();
+                for (std::thread& worker : workers) { worker.join(); }
+
+                if (error) { std::rethrow_exception(error); }
+            }
+
+        private:
+            unsigned m_threads;
+    };
+
+    namespace detail
+    {
+        template <typename Executor>
+        inline constexpr bool is_execution_policy_v =
+#if defined(FIBB_ARRAY_WRAPPER_EXECUTION_POLICIES)
+            std::is_execution_policy_v<std::remove_cv_t<std::remove_reference_t<Executor>>>;
+#else
+            false;
+#endif
+
+        template <typename Executor, typename = void>
+        struct has_concurrency : std::false_type {};
+
+        template <typename Executor>
+        struct has_concurrency<Executor, std::void_t<decltype(std::declval<const Executor&>().concurrency())>>
+            : std::true_type {};
+
+        template <typename Executor>
+        inline size_t concurrency_of(const Executor& executor) noexcept
+        {
+            size_t workers = std::thread::hardware_concurrency();
+            if constexpr (has_concurrency<Executor>::value) { workers = executor.concurrency(); }
+            else { static_cast<void>(executor); }
+            return workers == 0 ? 1 : workers;
+        }
+
+        template <typename Executor, typename Fn>
+        inline void run_bulk(Executor&& executor, size_t count, Fn fn)
+        {
+#if defined(FIBB_ARRAY_WRAPPER_EXECUTION_POLICIES)
+            if constexpr (is_execution_policy_v<Executor>)
+            {
+                std::vector<size_t> tasks(count);
+                std::iota(tasks.begin(), tasks.end(), size_t(0));
+                std::for_each(std::forward<Executor>(executor), tasks.begin(), tasks.end(), fn);
+            }
+            else
+#endif
+            {
+                executor.bulk(count, fn);
+            }
+        }
+
+        /* Splits n elements into about four chunks per worker so that a slow worker does not hold up the
+           rest. Every boundary apart from 0 and n falls on a cache line wherever the element size allows,
+           so two workers never write to the same line. Chunk 0 absorbs the elements before the first line. */
+
+        class Chunks
+        {
+            public:
+                template <typename T>
+                Chunks(const T* first, size_t n, size_t workers) noexcept
+                    : m_size(n), m_head(0), m_chunk(n)
+                {
+                    constexpr size_t line = FIBB_ARRAY_WRAPPER_CACHE_LINE;
+                    constexpr size_t line_elements = line / std::gcd(line, sizeof(T)); // elements in lcm(line, sizeof(T)) bytes
+
+                    const auto address = reinterpret_cast<std::uintptr_t>(first);
+                    while (m_head < line_elements && (address + m_head * sizeof(T)) % line != 0) { ++m_head; }
+                    if (m_head == line_elements) { m_head = 0; }
+
+                    const size_t min_chunk = std::max<size_t>(FIBB_ARRAY_WRAPPER_PARALLEL_CHUNK / sizeof(T), 1);
+                    const size_t chunk = std::max(min_chunk, n / (4 * workers));
+                    m_chunk = (chunk + line_elements - 1) / line_elements * line_elements;
+                }
+
+                size_t count() const noexcept
+                {
+                    if (m_size == 0) { return 0; }
+                    if (m_size <= m_head + m_chunk) { return 1; }
+                    return (m_size - m_head + m_chunk - 1) / m_chunk;
+                }
+
+                size_t offset(size_t k) const noexcept { return k == 0 ? 0 : m_head + k * m_chunk; }
+                size_t size(size_t k) const noexcept { return std::min(m_size, m_head + (k + 1) * m_chunk) - offset(k); }
+
+            private:
+                size_t m_size;
+                size_t m_head;
+                size_t m_chunk;
+        };
+
+        // position of the first element which is ordered differently from its counterpart, unordered
+        // floating point values are equivalent just like in std::lexicographical_compare
+        template <typename T>
+        inline size_t ordered_mismatch(const T* a, const T* b, size_t n)
+        {
+            size_t i = 0;
+            if constexpr (is_simd_comparable_v<const T>) { i = mismatch_index(a, b, n); }
+            for (; i < n; ++i)
+            {
+                if (a[i] < b[i] || b[i] < a[i]) { return i; }
+                if constexpr (is_simd_comparable_v<const T>) { i += mismatch_index(a + i + 1, b + i + 1, n - i - 1); }
+            }
+            return n;
+        }
+
+        template <typename T, size_t N, typename U, size_t M>
+        inline void check_same_size(const Array_Wrapper<T, N>& a, const Array_Wrapper<U, M>& b)
+        {
+            if constexpr (N != dynamic_extent && M != dynamic_extent)
+            {
+                static_assert(N == M, "Array_Wrappers must have the same size");
+            }
+            else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(a.size() != b.size()))
+            {
+                raise_length_error(a.size(), b.size());
+            }
+        }
+    }
+
+    /* PARALLEL ALGORITHMS */
+    // These split the wrapper into cache line aligned chunks and hand them to the executor, which is
+    // either a standard execution policy such as std::execution::par_unseq or an executor with a
+    // bulk() member like Thread_Executor. Each chunk uses the same kernels as the member functions.
+    // Wrappers below FIBB_ARRAY_WRAPPER_PARALLEL_CHUNK bytes are done on the calling thread.
+
+    template <typename Executor, typename T, size_t N>
+    inline void fill(Executor&& executor, Array_Wrapper<T, N> array_, const typename Array_Wrapper<T, N>::value_type& val)
+    {
+        const detail::Chunks chunks(array_.data(), array_.size(), detail::concurrency_of(executor));
+        if (chunks.count() <= 1) { array_.fill(val); return; }
+
+        // the streaming decision is made for the whole wrapper, the chunks are usually below the threshold
+        const bool streaming = detail::use_streaming_stores(array_.size() * sizeof(T));
+        detail::run_bulk(std::forward<Executor>(executor), chunks.count(), [&] (size_t k)
+        {
+            T* first = array_.data() + chunks.offset(k);
+            if constexpr (detail::is_bitwise_copy_assignable_v<T>)
+            {
+                if (streaming) { detail::stream_fill(first, chunks.size(k), val); }
+                else { detail::bitwise_fill(first, chunks.size(k), val); }
+            }
+            else
+            {
+                std::fill_n(first, chunks.size(k), val);
+            }
+        });
+    }
+
+    // Parallel counterpart of dest = src, src may be const. Overlapping wrappers are copied on the calling thread.
+    template <typename Executor, typename T, size_t N, typename U, size_t M>
+    inline void assign(Executor&& executor, Array_Wrapper<T, N> dest, Array_Wrapper<U, M> src)
+    {
+        static_assert(std::is_same_v<std::remove_const_t<U>, T>, "Destination must have the same, writable element type");
+        detail::check_same_size(dest, src);
+
+        const T* s = src.data();
+        T* d = dest.data();
+        const size_t n = dest.size();
+        const detail::Chunks chunks(d, n, detail::concurrency_of(executor));
+        if (chunks.count() <= 1 || s == d || (std::less<const T*>()(s, d + n) && std::less<const T*>()(d, s + n)))
+        {
+            // a named lvalue so that the elements are copied rather than moved
+            const Array_Wrapper<const T, dynamic_extent> source(s, n);
+            Array_Wrapper<T, dynamic_extent>(d, n) = source;
+            return;
+        }
+
+        const bool streaming = detail::use_streaming_stores(n * sizeof(T));
+        detail::run_bulk(std::forward<Executor>(executor), chunks.count(), [&] (size_t k)
+        {
+            const size_t offset = chunks.offset(k);
+            if constexpr (detail::is_bitwise_copy_assignable_v<T>)
+            {
+                if (streaming) { detail::stream_copy(d + offset, s + offset, chunks.size(k) * sizeof(T)); }
+                else { std::memcpy(d + offset, s + offset, chunks.size(k) * sizeof(T)); }
+            }
+            else
+            {
+                std::copy_n(s + offset, chunks.size(k), d + offset);
+            }
+        });
+    }
+
+    template <typename Executor, typename T, size_t N, size_t M>
+    inline void swap(Executor&& executor, Array_Wrapper<T, N> a, Array_Wrapper<T, M> b)
+    {
+        detail::check_same_size(a, b);
+
+        const detail::Chunks chunks(a.data(), a.size(), detail::concurrency_of(executor));
+        if (chunks.count() <= 1 || a.data() == b.data())
+        {
+            Array_Wrapper<T, dynamic_extent> all_b(b.data(), b.size());
+            Array_Wrapper<T, dynamic_extent>(a.data(), a.size()).swap(all_b);
+            return;
+        }
+
+        detail::run_bulk(std::forward<Executor>(executor), chunks.count(), [&] (size_t k)
+        {
+            Array_Wrapper<T, dynamic_extent> chunk_a(a.data() + chunks.offset(k), chunks.size(k));
+            Array_Wrapper<T, dynamic_extent> chunk_b(b.data() + chunks.offset(k), chunks.size(k));
+            chunk_a.swap(chunk_b);
+        });
+    }
+
+    // Parallel counterpart of a == b. Workers skip their chunk once any chunk has found a difference.
+    template <typename Executor, typename T, size_t N, size_t M>
+    inline bool equal(Executor&& executor, const Array_Wrapper<T, N>& a, const Array_Wrapper<T, M>& b)
+    {
+        if (a.size() != b.size()) { return false; }
+
+        const detail::Chunks chunks(a.data(), a.size(), detail::concurrency_of(executor));
+        if (chunks.count() <= 1) { return detail::equal_elements(a.data(), b.data(), a.size()); }
+
+        std::atomic<bool> different{false};
+        detail::run_bulk(std::forward<Executor>(executor), chunks.count(), [&] (size_t k)
+        {
+            if (different.load(std::memory_order_relaxed)) { return; }
+            if (!detail::equal_elements(a.data() + chunks.offset(k), b.data() + chunks.offset(k), chunks.size(k)))
+            {
+                different.store(true, std::memory_order_relaxed);
+            }
+        });
+        return !different.load(std::memory_order_relaxed);
+    }
+
+    // Parallel counterpart of a < b. Only the first differing chunk decides, so workers skip every
+    // chunk after the earliest difference found so far.
+    template <typename Executor, typename T, size_t N, size_t M>
+    inline bool lexicographical_compare(Executor&& executor, const Array_Wrapper<T, N>& a, const Array_Wrapper<T, M>& b)
+    {
+        const size_t n = std::min(a.size(), b.size());
+        const detail::Chunks chunks(a.data(), n, detail::concurrency_of(executor));
+        if (chunks.count() <= 1) { return detail::less_elements(a.data(), a.size(), b.data(), b.size()); }
+
+        std::atomic<size_t> first_chunk{chunks.count()};
+        std::vector<size_t> positions(chunks.count());
+        detail::run_bulk(std::forward<Executor>(executor), chunks.count(), [&] (size_t k)
+        {
+            size_t current = first_chunk.load(std::memory_order_relaxed);
+            if (current < k) { return; }
+
+            const size_t offset = chunks.offset(k);
+            positions[k] = offset + detail::ordered_mismatch(a.data() + offset, b.data() + offset, chunks.size(k));
+            if (positions[k] == offset + chunks.size(k)) { return; }
+
+            while (k < current && !first_chunk.compare_exchange_weak(current, k, std::memory_order_relaxed)) {}
+        });
+
+        // the executor has joined, so positions is visible here
+        const size_t k = first_chunk.load(std::memory_order_relaxed);
+        if (k == chunks.count()) { return a.size() < b.size(); }
+        return a[positions[k]] < b[positions[k]];
+    }
+}
+
+#endif
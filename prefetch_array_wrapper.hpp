@@ -0,0 +1,173 @@
+#ifndef FIBB_PREFETCH_ARRAY_WRAPPER
+#define FIBB_PREFETCH_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+// How far ahead of the cursor for_each_prefetched() prefetches, in bytes. Roughly memory latency times
+// the bytes consumed per unit of time, so more expensive functions want a shorter distance.
+#ifndef FIBB_ARRAY_WRAPPER_PREFETCH_DISTANCE
+    #define FIBB_ARRAY_WRAPPER_PREFETCH_DISTANCE 1024
+#endif
+
+// How many indices ahead for_each_indirect() prefetches the element an index refers to
+#ifndef FIBB_ARRAY_WRAPPER_GATHER_DISTANCE
+    #define FIBB_ARRAY_WRAPPER_GATHER_DISTANCE 16
+#endif
+
+namespace fibb
+{
+    namespace detail
+    {
+        // a hint only, it never faults and compiles to nothing where there is no prefetch instruction
+        inline void prefetch(const void* address) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+            __prefetch(address);
+#else
+            static_cast<void>(address);
+#endif
+        }
+
+        template <typename T>
+        inline constexpr size_t elements_per_line = sizeof(T) < FIBB_ARRAY_WRAPPER_CACHE_LINE
+            ? FIBB_ARRAY_WRAPPER_CACHE_LINE / sizeof(T) : 1;
+    }
+
+    /* PREFETCHED TRAVERSAL */
+    // Calls fn on every element in order, prefetching Distance bytes ahead of the cursor once per cache
+    // line. Returns fn like std::for_each.
+    template <size_t Distance = FIBB_ARRAY_WRAPPER_PREFETCH_DISTANCE, typename T, size_t N, typename Fn>
+    inline Fn for_each_prefetched(Array_Wrapper<T, N> array_, Fn fn)
+    {
+        constexpr size_t line = detail::elements_per_line<T>;
+        constexpr size_t ahead = (Distance + sizeof(T) - 1) / sizeof(T);
+
+        T* a = array_.data();
+        const size_t n = array_.size();
+
+        // stops prefetching where the target would be past the end
+        size_t i = 0;
+        for (; n > ahead && i + line <= n - ahead; i += line)
+        {
+            detail::prefetch(a + i + ahead);
+            for (size_t j = 0; j < line; ++j) { fn(a[i + j]); }
+        }
+        for (; i < n; ++i) { fn(a[i]); }
+        return fn;
+    }
+
+    // Calls fn(table[index]) for every index in order, prefetching the element Distance indices ahead,
+    // e.g. to walk an index table or a permutation. Indices are checked like at().
+    template <size_t Distance = FIBB_ARRAY_WRAPPER_GATHER_DISTANCE, typename I, size_t M, typename T, size_t N, typename Fn>
+    inline Fn for_each_indirect(const Array_Wrapper<I, M>& indices, Array_Wrapper<T, N> table, Fn fn)
+    {
+        static_assert(std::is_integral_v<std::remove_cv_t<I>>, "Indices must be integers");
+
+        const I* index = indices.data();
+        const size_t n = indices.size();
+
+        size_t i = 0;
+        for (; n > Distance && i < n - Distance; ++i)
+        {
+            const size_t target = static_cast<size_t>(index[i + Distance]);
+            if (target < table.size()) { detail::prefetch(table.data() + target); }
+            fn(table.at(static_cast<size_t>(index[i])));
+        }
+        for (; i < n; ++i) { fn(table.at(static_cast<size_t>(index[i]))); }
+        return fn;
+    }
+
+    /* CHUNKED TRAVERSAL */
+    /* A Chunk_Range splits a wrapper into consecutive dynamic sub-views of Bytes bytes, e.g. one per cache
+       line or page. When Bytes is a multiple of the element size the chunk boundaries fall on Bytes
+       aligned addresses, so the first and last chunks may be shorter. Chunks cover every element.
+
+           for (auto page : fibb::chunks<4096>(table)) { process(page); } */
+
+    template <typename T, size_t Bytes>
+    class Chunk_Range
+    {
+        public:
+            static_assert(Bytes != 0, "Chunks must not be empty");
+
+            static constexpr size_t chunk_size = Bytes >= sizeof(T) ? Bytes / sizeof(T) : 1;
+
+            class iterator
+            {
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = Array_Wrapper<T, dynamic_extent>;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = void;
+                    using reference = value_type;
+
+                    iterator() noexcept = default;
+
+                    value_type operator*() const noexcept { return value_type(m_first, static_cast<size_t>(m_next - m_first)); }
+
+                    iterator& operator++() noexcept
+                    {
+                        m_first = m_next;
+                        m_next = m_first + std::min(chunk_size, static_cast<size_t>(m_last - m_first));
+                        return *this;
+                    }
+
+                    iterator operator++(int) noexcept
+                    {
+                        iterator result = *this;
+                        ++*this;
+                        return result;
+                    }
+
+                    friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.m_first == b.m_first; }
+                    friend bool operator!=(const iterator& a, const iterator& b) noexcept { return a.m_first != b.m_first; }
+
+                private:
+                    friend class Chunk_Range;
+
+                    T* m_first = nullptr;
+                    T* m_next = nullptr; // end of the current chunk
+                    T* m_last = nullptr;
+
+                    iterator(T* first_, T* next_, T* last_) noexcept : m_first(first_), m_next(next_), m_last(last_) {}
+            };
+
+            Chunk_Range(T* first_, size_t size_) noexcept : m_first(first_), m_size(size_) {}
+
+            iterator begin() const noexcept
+            {
+                size_t head = chunk_size;
+                if constexpr (Bytes % sizeof(T) == 0)
+                {
+                    // elements up to the next boundary, a whole chunk if the array already starts on one
+                    const size_t offset = reinterpret_cast<std::uintptr_t>(m_first) % Bytes;
+                    if (offset % sizeof(T) == 0 && offset != 0) { head = (Bytes - offset) / sizeof(T); }
+                }
+                return iterator(m_first, m_first + std::min(head, m_size), m_first + m_size);
+            }
+
+            iterator end() const noexcept
+            {
+                T* last = m_first + m_size;
+                return iterator(last, last, last);
+            }
+
+            size_t size() const noexcept { return static_cast<size_t>(std::distance(begin(), end())); }
+
+        private:
+            T* m_first;
+            size_t m_size;
+    };
+
+    template <size_t Bytes = FIBB_ARRAY_WRAPPER_CACHE_LINE, typename T, size_t N>
+    inline Chunk_Range<T, Bytes> chunks(Array_Wrapper<T, N> array_) noexcept
+    {
+        return Chunk_Range<T, Bytes>(array_.data(), array_.size());
+    }
+}
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef FIBB_REDUCTION_ARRAY_WRAPPER
+#define FIBB_REDUCTION_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <utility>
+
+namespace fibb
+{
+    /* How sum() and dot() add up floating point values:
+       Sequential  - left to right exactly like std::accumulate, one dependent add per element
+       Reassociate - independent accumulators per vector lane, fastest but rounds differently from Sequential
+       Pairwise    - recursive halving over lane sized blocks, as fast as Reassociate with O(log n) error growth
+       Kahan       - compensated summation per lane, slower but the error barely grows with n. Needs strict
+                     floating point semantics, -ffast-math optimizes the compensation away.
+       All of them are deterministic for a given size. Integer sums are exact so the mode only affects speed. */
+
+    enum class Summation { Sequential, Reassociate, Pairwise, Kahan };
+
+    namespace detail
+    {
+        // enough independent accumulators to fill two 256 bit registers, so that the loop is bound by
+        // throughput rather than by the latency of a chain of dependent adds
+        template <typename T>
+        inline constexpr size_t reduction_lanes = sizeof(T) <= 16 && (sizeof(T) & (sizeof(T) - 1)) == 0 ? 64 / sizeof(T) : 4;
+
+        // tree combine of the lanes, L is a power of two
+        template <typename T, size_t L>
+        inline T combine_lanes(T (&acc)[L])
+        {
+            for (size_t width = L / 2; width > 0; width /= 2)
+            {
+                for (size_t j = 0; j < width; ++j) { acc[j] += acc[j + width]; }
+            }
+            return acc[0];
+        }
+
+        // Term is called with an index and returns the value to add, which lets dot() share the kernels
+        template <typename T, typename Term>
+        inline T sum_sequential(size_t first, size_t n, Term& term)
+        {
+            T result{};
+            for (size_t i = first; i < first + n; ++i) { result += term(i); }
+            return result;
+        }
+
+        template <typename T, typename Term>
+        inline T sum_lanes(size_t first, size_t n, Term& term)
+        {
+            constexpr size_t L = reduction_lanes<T>;
+            T acc[L] = {};
+
+            size_t i = first;
+            const size_t last = first + n;
+            for (; i + L <= last; i += L)
+            {
+                for (size_t j = 0; j < L; ++j) { acc[j] += term(i + j); }
+            }
+
+            T result = combine_lanes(acc);
+            for (; i < last; ++i) { result += term(i); }
+            return result;
+        }
+
+        template <typename T, typename Term>
+        inline T sum_pairwise(size_t first, size_t n, Term& term)
+        {
+            constexpr size_t L = reduction_lanes<T>;
+            if (n <= 8 * L) { return sum_lanes<T>(first, n, term); }
+
+            // split on a lane boundary so that every block but the last runs without a tail
+            const size_t half = n / 2 / L * L;
+            return sum_pairwise<T>(first, half, term) + sum_pairwise<T>(first + half, n - half, term);
+        }
+
+        template <typename T>
+        class Kahan_Accumulator
+        {
+            public:
+                void add(const T& value)
+                {
+                    const T y = value - m_compensation;
+                    const T t = m_sum + y;
+                    m_compensation = (t - m_sum) - y;
+                    m_sum = t;
+                }
+
+                const T& sum() const noexcept { return m_sum; }
+                const T& compensation() const noexcept { return m_compensation; }
+
+            private:
+                T m_sum{};
+                T m_compensation{};
+        };
+
+        template <typename T, typename Term>
+        inline T sum_kahan(size_t first, size_t n, Term& term)
+        {
+            constexpr size_t L = reduction_lanes<T>;
+            T sum[L] = {};
+            T compensation[L] = {};
+
+            size_t i = first;
+            const size_t last = first + n;
+            for (; i + L <= last; i += L)
+            {
+                for (size_t j = 0; j < L; ++j)
+                {
+                    const T y = term(i + j) - compensation[j];
+                    const T t = sum[j] + y;
+                    compensation[j] = (t - sum[j]) - y;
+                    sum[j] = t;
+                }
+            }
+
+            Kahan_Accumulator<T> result;
+            for (size_t j = 0; j < L; ++j)
+            {
+                result.add(sum[j]);
+                result.add(-compensation[j]);
+            }
+            for (; i < last; ++i) { result.add(term(i)); }
+            return result.sum() - result.compensation();
+        }
+
+        template <Summation Mode, typename T, typename Term>
+        inline T sum_terms(size_t n, Term term)
+        {
+            if constexpr (Mode == Summation::Sequential) { return sum_sequential<T>(0, n, term); }
+            else if constexpr (Mode == Summation::Reassociate) { return sum_lanes<T>(0, n, term); }
+            else if constexpr (Mode == Summation::Pairwise) { return sum_pairwise<T>(0, n, term); }
+            else { return sum_kahan<T>(0, n, term); }
+        }
+
+        // Better(x, m) is true if x should replace m. Every lane starts from the first element, so like
+        // std::min_element a leading NaN is returned and later ones are skipped.
+        template <typename T, typename Better>
+        inline T select_lanes(const T* a, size_t n, Better better)
+        {
+            constexpr size_t L = reduction_lanes<T>;
+            T acc[L];
+            std::fill_n(acc, L, a[0]);
+
+            size_t i = 0;
+            for (; i + L <= n; i += L)
+            {
+                for (size_t j = 0; j < L; ++j) { acc[j] = better(a[i + j], acc[j]) ? a[i + j] : acc[j]; }
+            }
+
+            T result = acc[0];
+            for (size_t j = 1; j < L; ++j) { result = better(acc[j], result) ? acc[j] : result; }
+            for (; i < n; ++i) { result = better(a[i], result) ? a[i] : result; }
+            return result;
+        }
+
+        template <typename T>
+        inline std::pair<T, T> minmax_lanes(const T* a, size_t n)
+        {
+            constexpr size_t L = reduction_lanes<T>;
+            T low[L];
+            T high[L];
+            std::fill_n(low, L, a[0]);
+            std::fill_n(high, L, a[0]);
+
+            size_t i = 0;
+            for (; i + L <= n; i += L)
+            {
+                for (size_t j = 0; j < L; ++j)
+                {
+                    low[j] = a[i + j] < low[j] ? a[i + j] : low[j];
+                    high[j] = high[j] < a[i + j] ? a[i + j] : high[j];
+                }
+            }
+
+            std::pair<T, T> result(low[0], high[0]);
+            for (size_t j = 1; j < L; ++j)
+            {
+                result.first = low[j] < result.first ? low[j] : result.first;
+                result.second = result.second < high[j] ? high[j] : result.second;
+            }
+            for (; i < n; ++i)
+            {
+                result.first = a[i] < result.first ? a[i] : result.first;
+                result.second = result.second < a[i] ? a[i] : result.second;
+            }
+            return result;
+        }
+
+        template <typename T, size_t N>
+        inline void check_not_empty(const Array_Wrapper<T, N>& array_)
+        {
+            if constexpr (N == dynamic_extent)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(array_.empty())) { raise_range_error(0); }
+            }
+            else
+            {
+                static_assert(N != 0, "Array_Wrapper must not be empty");
+            }
+        }
+    }
+
+    /* REDUCTIONS */
+    // Floating point sums default to Pairwise, see Summation.
+    template <Summation Mode = Summation::Pairwise, typename T, size_t N>
+    inline std::remove_cv_t<T> sum(const Array_Wrapper<T, N>& array_)
+    {
+        const T* a = array_.data();
+        return detail::sum_terms<Mode, std::remove_cv_t<T>>(array_.size(), [a] (size_t i) { return a[i]; });
+    }
+
+    template <Summation Mode = Summation::Pairwise, typename T, size_t N, typename U, size_t M>
+    inline auto dot(const Array_Wrapper<T, N>& a, const Array_Wrapper<U, M>& b)
+    {
+        using result_type = std::remove_cv_t<decltype(a[0] * b[0])>;
+
+        if constexpr (N != dynamic_extent && M != dynamic_extent)
+        {
+            static_assert(N == M, "Array_Wrappers must have the same size");
+        }
+        else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(a.size() != b.size()))
+        {
+            detail::raise_length_error(a.size(), b.size());
+        }
+
+        const T* x = a.data();
+        const U* y = b.data();
+        return detail::sum_terms<Mode, result_type>(a.size(), [x, y] (size_t i) { return x[i] * y[i]; });
+    }
+
+    // the smallest element by operator<, the wrapper must not be empty
+    template <typename T, size_t N>
+    inline std::remove_cv_t<T> min(const Array_Wrapper<T, N>& array_)
+    {
+        detail::check_not_empty(array_);
+        return detail::select_lanes<std::remove_cv_t<T>>(array_.data(), array_.size(), [] (const T& x, const T& m) { return x < m; });
+    }
+
+    template <typename T, size_t N>
+    inline std::remove_cv_t<T> max(const Array_Wrapper<T, N>& array_)
+    {
+        detail::check_not_empty(array_);
+        return detail::select_lanes<std::remove_cv_t<T>>(array_.data(), array_.size(), [] (const T& x, const T& m) { return m < x; });
+    }
+
+    // both in a single pass
+    template <typename T, size_t N>
+    inline std::pair<std::remove_cv_t<T>, std::remove_cv_t<T>> minmax(const Array_Wrapper<T, N>& array_)
+    {
+        detail::check_not_empty(array_);
+        return detail::minmax_lanes<std::remove_cv_t<T>>(array_.data(), array_.size());
+    }
+
+    template <typename T, size_t N, typename Predicate>
+    inline size_t count_if(const Array_Wrapper<T, N>& array_, Predicate pred)
+    {
+        const T* a = array_.data();
+        return detail::sum_terms<Summation::Reassociate, size_t>(array_.size(),
+            [a, &pred] (size_t i) { return static_cast<size_t>(static_cast<bool>(pred(a[i]))); });
+    }
+
+    template <typename T, size_t N>
+    inline size_t count(const Array_Wrapper<T, N>& array_, const std::remove_cv_t<T>& value)
+    {
+        return count_if(array_, [&value] (const T& x) { return x == value; });
+    }
+
+    // Tests a block of elements without branching before deciding whether to stop, so the block
+    // vectorizes while the scan still exits early.
+    template <typename T, size_t N, typename Predicate>
+    inline bool any_of(const Array_Wrapper<T, N>& array_, Predicate pred)
+    {
+        constexpr size_t block = 4 * detail::reduction_lanes<T>;
+        const T* a = array_.data();
+        const size_t n = array_.size();
+
+        size_t i = 0;
+        for (; i + block <= n; i += block)
+        {
+            bool found = false;
+            for (size_t j = 0; j < block; ++j) { found |= static_cast<bool>(pred(a[i + j])); }
+            if (found) { return true; }
+        }
+        for (; i < n; ++i)
+        {
+            if (pred(a[i])) { return true; }
+        }
+        return false;
+    }
+
+    template <typename T, size_t N, typename Predicate>
+    inline bool all_of(const Array_Wrapper<T, N>& array_, Predicate pred)
+    {
+        return !any_of(array_, [&pred] (const T& x) { return !pred(x); });
+    }
+
+    template <typename T, size_t N, typename Predicate>
+    inline bool none_of(const Array_Wrapper<T, N>& array_, Predicate pred)
+    {
+        return !any_of(array_, pred);
+    }
+}
+
+#endif
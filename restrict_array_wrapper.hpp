@@ -0,0 +1,148 @@
+#ifndef FIBB_RESTRICT_ARRAY_WRAPPER
+#define FIBB_RESTRICT_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+    #define FIBB_ARRAY_WRAPPER_RESTRICT __restrict
+#else
+    #define FIBB_ARRAY_WRAPPER_RESTRICT
+#endif
+
+namespace fibb
+{
+    /* The Restrict_Array_Wrapper marks an Array_Wrapper as not overlapping any other Restrict_Array_Wrapper
+       it is combined with. Compilers only act on restrict for function parameters and local pointers, so
+       the promise pays off in two places: the transform() algorithms below, whose kernels take restrict
+       qualified pointers and therefore vectorize without runtime overlap tests, and restrict_pointer for
+       hand written loops, e.g.
+
+           fibb::Restrict_Array_Wrapper<float, N>::restrict_pointer out = wrapper.data();
+
+       The algorithms check that the output really is disjoint from every input through the usual check
+       policy. The one exception is an output which is exactly one of the inputs, e.g. y = a * x + y,
+       which is done in place without restrict. Inputs may overlap each other since they are only read. */
+
+    template <typename T, size_t N>
+    class Restrict_Array_Wrapper : public Array_Wrapper<T, N>
+    {
+        private:
+            using base_type = Array_Wrapper<T, N>;
+
+        public:
+            /* TYPES */
+            using typename base_type::pointer;
+            using typename base_type::size_type;
+            using restrict_pointer = T* FIBB_ARRAY_WRAPPER_RESTRICT;
+
+            /* CONSTRUCTORS */
+            template <size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            constexpr Restrict_Array_Wrapper(T (&array_)[M]) noexcept // sized array
+                : base_type(array_)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            constexpr Restrict_Array_Wrapper(T*& array_) noexcept // decayed array pointer
+                : base_type(array_)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            constexpr Restrict_Array_Wrapper(pointer array_, size_type size_) noexcept // pointer and runtime size
+                : base_type(array_, size_)
+            {}
+
+            // opting a plain wrapper in is a promise about the caller's data so it is explicit
+            constexpr explicit Restrict_Array_Wrapper(const base_type& other) noexcept
+                : base_type(other)
+            {}
+
+            // the same conversions as Array_Wrapper, i.e. to a dynamic wrapper with the same or const elements
+            template <typename U, size_t M,
+                std::enable_if_t<!std::is_same_v<U, T> || M != N, int> = 0,
+                std::enable_if_t<std::is_convertible_v<Array_Wrapper<U, M>&, base_type>, int> = 0>
+            constexpr Restrict_Array_Wrapper(Restrict_Array_Wrapper<U, M> other) noexcept
+                : base_type(static_cast<Array_Wrapper<U, M>&>(other))
+            {}
+
+            constexpr Restrict_Array_Wrapper(const Restrict_Array_Wrapper&) = default;
+
+            /* ASSIGNMENT */
+            // copies elements like Array_Wrapper, the implicit copy assignment forwards to it
+            using base_type::operator=;
+    };
+
+    template <typename T, size_t N>
+    Restrict_Array_Wrapper(T (&)[N]) -> Restrict_Array_Wrapper<T, N>;
+
+    template <typename T>
+    Restrict_Array_Wrapper(T*, size_t) -> Restrict_Array_Wrapper<T, dynamic_extent>;
+
+    template <typename T, size_t N>
+    Restrict_Array_Wrapper(const Array_Wrapper<T, N>&) -> Restrict_Array_Wrapper<T, N>;
+
+    namespace detail
+    {
+        template <typename Out, typename In, typename Fn>
+        inline void transform_restrict(Out* FIBB_ARRAY_WRAPPER_RESTRICT out, const In* FIBB_ARRAY_WRAPPER_RESTRICT in,
+            size_t n, Fn& fn)
+        {
+            for (size_t i = 0; i < n; ++i) { out[i] = fn(in[i]); }
+        }
+
+        // a and b may alias each other, restrict only forbids aliasing through a modified object
+        template <typename Out, typename A, typename B, typename Fn>
+        inline void transform_restrict(Out* FIBB_ARRAY_WRAPPER_RESTRICT out, const A* FIBB_ARRAY_WRAPPER_RESTRICT a,
+            const B* FIBB_ARRAY_WRAPPER_RESTRICT b, size_t n, Fn& fn)
+        {
+            for (size_t i = 0; i < n; ++i) { out[i] = fn(a[i], b[i]); }
+        }
+
+        // true if out and in are the same elements, in which case the aliasing kernel has to be used
+        template <typename Out, size_t N, typename In, size_t M>
+        inline bool check_restrict(const Restrict_Array_Wrapper<Out, N>& out, const Restrict_Array_Wrapper<In, M>& in)
+        {
+            if constexpr (N != dynamic_extent && M != dynamic_extent)
+            {
+                static_assert(N == M, "Restrict_Array_Wrappers must have the same size");
+            }
+            else if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(out.size() != in.size()))
+            {
+                raise_length_error(out.size(), in.size());
+            }
+
+            const auto* out_first = reinterpret_cast<const unsigned char*>(out.data());
+            const auto* in_first = reinterpret_cast<const unsigned char*>(in.data());
+            if (out_first == in_first && sizeof(Out) == sizeof(In)) { return true; }
+
+            const std::less<const unsigned char*> less;
+            if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(out.size() != 0 && in.size() != 0
+                && less(out_first, in_first + in.size() * sizeof(In)) && less(in_first, out_first + out.size() * sizeof(Out))))
+            {
+                raise_invalid_argument("Overlapping restrict wrappers at: ", reinterpret_cast<std::uintptr_t>(out_first));
+            }
+            return false;
+        }
+    }
+
+    /* RESTRICT ALGORITHMS */
+    // out[i] = fn(in[i])
+    template <typename Out, size_t N, typename In, size_t M, typename Fn>
+    inline void transform(Restrict_Array_Wrapper<Out, N> out, const Restrict_Array_Wrapper<In, M>& in, Fn fn)
+    {
+        if (detail::check_restrict(out, in)) { std::transform(in.begin(), in.end(), out.begin(), fn); }
+        else { detail::transform_restrict(out.data(), in.data(), out.size(), fn); }
+    }
+
+    // out[i] = fn(a[i], b[i])
+    template <typename Out, size_t N, typename A, size_t M, typename B, size_t K, typename Fn>
+    inline void transform(Restrict_Array_Wrapper<Out, N> out, const Restrict_Array_Wrapper<A, M>& a,
+        const Restrict_Array_Wrapper<B, K>& b, Fn fn)
+    {
+        const bool in_place_a = detail::check_restrict(out, a);
+        const bool in_place_b = detail::check_restrict(out, b);
+        if (in_place_a || in_place_b) { std::transform(a.begin(), a.end(), b.begin(), out.begin(), fn); }
+        else { detail::transform_restrict(out.data(), a.data(), b.data(), out.size(), fn); }
+    }
+}
+
+#endif
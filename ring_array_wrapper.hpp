@@ -0,0 +1,345 @@
+#ifndef FIBB_RING_ARRAY_WRAPPER
+#define FIBB_RING_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <atomic>
+
+namespace fibb
+{
+    // Up to two contiguous runs of a Ring_Wrapper, the second one is only non-empty when the run wraps
+    // around the end of the array
+    template <typename T>
+    struct Ring_Segments
+    {
+        Array_Wrapper<T, dynamic_extent> first;
+        Array_Wrapper<T, dynamic_extent> second;
+
+        size_t size() const noexcept { return first.size() + second.size(); }
+        bool empty() const noexcept { return size() == 0; }
+    };
+
+    /* The Ring_Wrapper uses a wrapped array as a fixed capacity FIFO queue. Every slot of the array
+       is used, and slots are assigned to rather than constructed, like the elements of the array.
+
+       Indices never need a modulo: a fixed power of two N is handled by masking free running counters,
+       any other capacity by counters which wrap at twice the capacity with a compare and subtract.
+
+       With Concurrent set the ring is a lock-free single producer, single consumer queue. One thread may
+       push and another pop at the same time. The producer and consumer indices sit on cache lines of
+       their own, and each side keeps a cached copy of the other's index, so that it only reads the
+       shared one when the cached copy says the ring is full or empty. size(), empty() and full() are
+       then estimates: either index may move between the two loads, so size() is only guaranteed to lie
+       between 0 and capacity(), and may be stale by the time it returns.
+
+       The bulk interface hands out the free or filled slots as at most two Array_Wrappers. They can be
+       copied with memcpy or filled by read(), and the transfer is completed with commit_write() or
+       commit_read(). */
+
+    template <typename T, size_t N = dynamic_extent, bool Concurrent = false>
+    class Ring_Wrapper
+    {
+        public:
+            /* TYPES */
+            using value_type = std::remove_cv_t<T>;
+            using size_type = size_t;
+            using reference = T&;
+            using const_reference = const T&;
+
+            static constexpr size_type extent = N;
+            static constexpr bool is_concurrent = Concurrent;
+
+            static_assert(!std::is_const_v<T>, "Ring_Wrapper elements must be writable");
+            static_assert(N != 0, "Ring_Wrapper needs at least one slot");
+
+            /* CONSTRUCTORS */
+            template <size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            Ring_Wrapper(T (&array_)[M]) noexcept // sized array
+                : m_array(array_)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M != dynamic_extent, int> = 0>
+            Ring_Wrapper(T*& array_) noexcept // decayed array pointer
+                : m_array(array_)
+            {}
+
+            template <size_t M = N, std::enable_if_t<M == dynamic_extent, int> = 0>
+            Ring_Wrapper(T* array_, size_type size_) // pointer and runtime size
+                : m_array(array_, size_)
+            {
+                check_capacity();
+            }
+
+            explicit Ring_Wrapper(const Array_Wrapper<T, N>& array_)
+                : m_array(array_)
+            {
+                if constexpr (N == dynamic_extent) { check_capacity(); }
+            }
+
+            /* CAPACITY */
+            constexpr size_type capacity() const noexcept { return m_array.size(); }
+
+            size_type size() const noexcept
+            {
+                // The tail first so that it can't overtake a head read after it. The producer may still
+                // refill the slots popped in between, which could put the head further than capacity()
+                // ahead, or for counters which wrap at twice the capacity make it look behind.
+                const size_type tail = load_tail_acquire();
+                return std::min(distance(load_head_acquire(), tail), capacity());
+            }
+
+            bool empty() const noexcept { return size() == 0; }
+            bool full() const noexcept { return size() == capacity(); }
+
+            /* PRODUCER */
+            // false if the ring is full
+            bool push(const value_type& val)
+            {
+                const size_type head = load_head();
+                if (free_slots(head, 1) == 0) { return false; }
+                m_array.data()[slot(head)] = val;
+                store_head(advance(head, 1));
+                return true;
+            }
+
+            bool push(value_type&& val)
+            {
+                const size_type head = load_head();
+                if (free_slots(head, 1) == 0) { return false; }
+                m_array.data()[slot(head)] = std::move(val);
+                store_head(advance(head, 1));
+                return true;
+            }
+
+            // copies as many leading values as fit, returns how many that was
+            template <typename U, size_t M>
+            size_type push(const Array_Wrapper<U, M>& values)
+            {
+                Ring_Segments<T> segments = write_segments(values.size());
+                const U* src = values.data();
+                std::copy_n(src, segments.first.size(), segments.first.data());
+                std::copy_n(src + segments.first.size(), segments.second.size(), segments.second.data());
+                commit_write(segments.size());
+                return segments.size();
+            }
+
+            // Free slots to write to, at most max_count of them. Nothing is visible to the consumer
+            // until commit_write().
+            Ring_Segments<T> write_segments(size_type max_count = dynamic_extent)
+            {
+                const size_type head = load_head();
+                return segments(head, std::min(free_slots(head, max_count), max_count));
+            }
+
+            // publishes the first count slots handed out by write_segments()
+            void commit_write(size_type count)
+            {
+                const size_type head = load_head();
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(count > free_slots(head, count)))
+                {
+                    detail::raise_length_error(free_slots(head, count), count);
+                }
+                store_head(advance(head, count));
+            }
+
+            /* CONSUMER */
+            // false if the ring is empty
+            bool pop(value_type& val)
+            {
+                const size_type tail = load_tail();
+                if (filled_slots(tail, 1) == 0) { return false; }
+                val = std::move(m_array.data()[slot(tail)]);
+                store_tail(advance(tail, 1));
+                return true;
+            }
+
+            // moves out as many values as are available and fit, returns how many that was
+            template <size_t M>
+            size_type pop(Array_Wrapper<T, M> values)
+            {
+                Ring_Segments<T> segments = read_segments(values.size());
+                T* dest = values.data();
+                std::move(segments.first.begin(), segments.first.end(), dest);
+                std::move(segments.second.begin(), segments.second.end(), dest + segments.first.size());
+                commit_read(segments.size());
+                return segments.size();
+            }
+
+            // Filled slots in FIFO order, at most max_count of them. They stay owned by the consumer
+            // until commit_read().
+            Ring_Segments<T> read_segments(size_type max_count = dynamic_extent)
+            {
+                const size_type tail = load_tail();
+                return segments(tail, std::min(filled_slots(tail, max_count), max_count));
+            }
+
+            // releases the first count slots handed out by read_segments() to the producer
+            void commit_read(size_type count)
+            {
+                const size_type tail = load_tail();
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(count > filled_slots(tail, count)))
+                {
+                    detail::raise_length_error(filled_slots(tail, count), count);
+                }
+                store_tail(advance(tail, count));
+            }
+
+            // drops every element, consumer side
+            void clear() noexcept
+            {
+                const size_type head = load_head_acquire();
+                if constexpr (Concurrent) { m_cached_head = head; }
+                store_tail(head);
+            }
+
+        private:
+            static constexpr bool is_masked = N != dynamic_extent && (N & (N - 1)) == 0;
+
+            using index_type = std::conditional_t<Concurrent, std::atomic<size_type>, size_type>;
+
+            Array_Wrapper<T, N> m_array;
+
+            // written by the producer; the cached tail is the producer's last view of m_tail
+            alignas(Concurrent ? FIBB_ARRAY_WRAPPER_CACHE_LINE : alignof(size_type)) index_type m_head{0};
+            size_type m_cached_tail = 0;
+
+            // written by the consumer; the cached head is the consumer's last view of m_head
+            alignas(Concurrent ? FIBB_ARRAY_WRAPPER_CACHE_LINE : alignof(size_type)) index_type m_tail{0};
+            size_type m_cached_head = 0;
+
+            void check_capacity()
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(m_array.size() == 0 || m_array.size() > dynamic_extent / 2))
+                {
+                    detail::raise_invalid_argument("Invalid ring capacity: ", m_array.size());
+                }
+            }
+
+            /* INDICES */
+            // masked indices run freely, the others stay below twice the capacity so that a full ring
+            // can be told apart from an empty one
+
+            constexpr size_type advance(size_type index, size_type count) const noexcept
+            {
+                if constexpr (is_masked) { return index + count; }
+                else
+                {
+                    const size_type next = index + count;
+                    return next >= 2 * capacity() ? next - 2 * capacity() : next;
+                }
+            }
+
+            constexpr size_type distance(size_type head, size_type tail) const noexcept
+            {
+                if constexpr (is_masked) { return head - tail; }
+                else { return head >= tail ? head - tail : head + 2 * capacity() - tail; }
+            }
+
+            constexpr size_type slot(size_type index) const noexcept
+            {
+                if constexpr (is_masked) { return index & (N - 1); }
+                else { return index >= capacity() ? index - capacity() : index; }
+            }
+
+            Ring_Segments<T> segments(size_type index, size_type count) noexcept
+            {
+                const size_type first = slot(index);
+                const size_type first_count = std::min(count, capacity() - first);
+                return Ring_Segments<T>{Array_Wrapper<T, dynamic_extent>(m_array.data() + first, first_count),
+                    Array_Wrapper<T, dynamic_extent>(m_array.data(), count - first_count)};
+            }
+
+            // Each side reads its own index relaxed, since only it writes it, and the other side's with
+            // acquire so that the slots it released are visible. The cached copy is refreshed only when
+            // it can't satisfy the request.
+
+            size_type free_slots(size_type head, size_type wanted)
+            {
+                if constexpr (Concurrent)
+                {
+                    size_type available = capacity() - distance(head, m_cached_tail);
+                    if (available < wanted)
+                    {
+                        m_cached_tail = m_tail.load(std::memory_order_acquire);
+                        available = capacity() - distance(head, m_cached_tail);
+                    }
+                    return available;
+                }
+                else
+                {
+                    static_cast<void>(wanted);
+                    return capacity() - distance(head, m_tail);
+                }
+            }
+
+            size_type filled_slots(size_type tail, size_type wanted)
+            {
+                if constexpr (Concurrent)
+                {
+                    size_type available = distance(m_cached_head, tail);
+                    if (available < wanted)
+                    {
+                        m_cached_head = m_head.load(std::memory_order_acquire);
+                        available = distance(m_cached_head, tail);
+                    }
+                    return available;
+                }
+                else
+                {
+                    static_cast<void>(wanted);
+                    return distance(m_head, tail);
+                }
+            }
+
+            size_type load_head() const noexcept
+            {
+                if constexpr (Concurrent) { return m_head.load(std::memory_order_relaxed); }
+                else { return m_head; }
+            }
+
+            size_type load_head_acquire() const noexcept
+            {
+                if constexpr (Concurrent) { return m_head.load(std::memory_order_acquire); }
+                else { return m_head; }
+            }
+
+            size_type load_tail() const noexcept
+            {
+                if constexpr (Concurrent) { return m_tail.load(std::memory_order_relaxed); }
+                else { return m_tail; }
+            }
+
+            size_type load_tail_acquire() const noexcept
+            {
+                if constexpr (Concurrent) { return m_tail.load(std::memory_order_acquire); }
+                else { return m_tail; }
+            }
+
+            void store_head(size_type head) noexcept
+            {
+                if constexpr (Concurrent) { m_head.store(head, std::memory_order_release); }
+                else { m_head = head; }
+            }
+
+            void store_tail(size_type tail) noexcept
+            {
+                if constexpr (Concurrent) { m_tail.store(tail, std::memory_order_release); }
+                else { m_tail = tail; }
+            }
+    };
+
+    template <typename T, size_t N>
+    Ring_Wrapper(T (&)[N]) -> Ring_Wrapper<T, N>;
+
+    template <typename T>
+    Ring_Wrapper(T*, size_t) -> Ring_Wrapper<T, dynamic_extent>;
+
+    template <typename T, size_t N>
+    Ring_Wrapper(const Array_Wrapper<T, N>&) -> Ring_Wrapper<T, N>;
+
+    // the lock-free single producer, single consumer variant
+    template <typename T, size_t N = dynamic_extent>
+    using SPSC_Ring_Wrapper = Ring_Wrapper<T, N, true>;
+}
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef FIBB_SERIAL_ARRAY_WRAPPER
+#define FIBB_SERIAL_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#if __has_include(<sys/uio.h>)
+    #include <sys/uio.h>
+    #define FIBB_ARRAY_WRAPPER_IOVEC
+#endif
+
+namespace fibb
+{
+    /* Byte order of serialized elements. Native is whichever of the two the host uses. */
+
+    enum class Endian
+    {
+        Little,
+        Big,
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        Native = Big
+#else
+        Native = Little
+#endif
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        inline constexpr bool is_serializable_v = std::is_trivially_copyable_v<T>;
+
+        // types whose byte order byteswap() knows how to reverse
+        template <typename T>
+        inline constexpr bool is_byte_swappable_v = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+            && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        template <typename T, size_t N>
+        inline constexpr size_t byte_extent = N == dynamic_extent ? dynamic_extent : N * sizeof(T);
+
+        template <typename Byte, size_t N>
+        inline Array_Wrapper<Byte, N> make_byte_wrapper(Byte* bytes, size_t size)
+        {
+            if constexpr (N == dynamic_extent) { return Array_Wrapper<Byte, N>(bytes, size); }
+            else { return Array_Wrapper<Byte, N>(bytes); }
+        }
+
+        /* BYTE SWAP KERNELS */
+        inline std::uint16_t byteswap_word(std::uint16_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_bswap16(x);
+#elif defined(_MSC_VER)
+            return _byteswap_ushort(x);
+#else
+            return static_cast<std::uint16_t>((x << 8) | (x >> 8));
+#endif
+        }
+
+        inline std::uint32_t byteswap_word(std::uint32_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_bswap32(x);
+#elif defined(_MSC_VER)
+            return _byteswap_ulong(x);
+#else
+            return (x << 24) | ((x << 8) & 0x00FF0000u) | ((x >> 8) & 0x0000FF00u) | (x >> 24);
+#endif
+        }
+
+        inline std::uint64_t byteswap_word(std::uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_bswap64(x);
+#elif defined(_MSC_VER)
+            return _byteswap_uint64(x);
+#else
+            return (static_cast<std::uint64_t>(byteswap_word(static_cast<std::uint32_t>(x))) << 32)
+                | byteswap_word(static_cast<std::uint32_t>(x >> 32));
+#endif
+        }
+
+        template <size_t Width>
+        using byteswap_word_t = std::conditional_t<Width == 2, std::uint16_t,
+            std::conditional_t<Width == 4, std::uint32_t, std::uint64_t>>;
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD) && defined(__SSSE3__)
+        // shuffle control reversing every Width byte group of a 128 bit lane
+        template <size_t Width>
+        inline __m128i byteswap_mask() noexcept
+        {
+            alignas(16) unsigned char mask[16];
+            for (size_t j = 0; j < 16; ++j) { mask[j] = static_cast<unsigned char>(j / Width * Width + (Width - 1 - j % Width)); }
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+        }
+#endif
+
+        // reverses the byte order of n elements of Width bytes each
+        template <size_t Width>
+        inline void swap_byte_order(unsigned char* bytes, size_t n) noexcept
+        {
+            static_assert(Width == 2 || Width == 4 || Width == 8);
+
+            const size_t size = n * Width;
+            size_t i = 0;
+
+#if defined(FIBB_ARRAY_WRAPPER_X86_SIMD) && defined(__SSSE3__)
+            const __m128i mask = byteswap_mask<Width>();
+    #if defined(__AVX2__)
+            const __m256i wide_mask = _mm256_broadcastsi128_si256(mask); // the shuffle works per 128 bit lane
+            for (; i + 32 <= size; i += 32)
+            {
+                __m256i* p = reinterpret_cast<__m256i*>(bytes + i);
+                _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), wide_mask));
+            }
+    #endif
+            for (; i + 16 <= size; i += 16)
+            {
+                __m128i* p = reinterpret_cast<__m128i*>(bytes + i);
+                _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+            }
+#elif defined(FIBB_ARRAY_WRAPPER_NEON_SIMD)
+            for (; i + 16 <= size; i += 16)
+            {
+                const uint8x16_t v = vld1q_u8(bytes + i);
+                if constexpr (Width == 2) { vst1q_u8(bytes + i, vrev16q_u8(v)); }
+                else if constexpr (Width == 4) { vst1q_u8(bytes + i, vrev32q_u8(v)); }
+                else { vst1q_u8(bytes + i, vrev64q_u8(v)); }
+            }
+#endif
+            for (; i < size; i += Width)
+            {
+                byteswap_word_t<Width> word;
+                std::memcpy(&word, bytes + i, Width);
+                word = byteswap_word(word);
+                std::memcpy(bytes + i, &word, Width);
+            }
+        }
+
+        // untrusted input is always validated, the check policy only decides how a failure is reported
+        inline void check_decoded(bool failed, const char* what, size_t value)
+        {
+            if (FIBB_ARRAY_WRAPPER_UNLIKELY(failed)) { raise_invalid_argument(what, value); }
+        }
+
+        template <typename T, size_t N, typename Byte, size_t M>
+        inline Array_Wrapper<T, N> wrap_bytes(Array_Wrapper<Byte, M> bytes_, size_t count)
+        {
+            static_assert(std::is_same_v<std::remove_const_t<Byte>, unsigned char>, "Bytes must be unsigned char");
+            static_assert(!std::is_const_v<Byte> || std::is_const_v<T>, "Const bytes can only be viewed as const elements");
+            static_assert(is_serializable_v<std::remove_const_t<T>>, "Elements must be trivially copyable");
+
+            check_decoded(count > bytes_.size() / sizeof(T), "Buffer too small for elements: ", count);
+            check_decoded(reinterpret_cast<std::uintptr_t>(bytes_.data()) % alignof(T) != 0,
+                "Misaligned buffer: ", reinterpret_cast<std::uintptr_t>(bytes_.data()));
+
+            T* first = reinterpret_cast<T*>(bytes_.data());
+            if constexpr (N == dynamic_extent) { return Array_Wrapper<T, N>(first, count); }
+            else
+            {
+                check_decoded(count != N, "Unexpected number of elements: ", count);
+                return Array_Wrapper<T, N>(first);
+            }
+        }
+    }
+
+    /* BYTE VIEWS */
+    // the object representation of the elements, e.g. for write() or a checksum
+    template <typename T, size_t N>
+    inline Array_Wrapper<const unsigned char, detail::byte_extent<T, N>> as_bytes(const Array_Wrapper<T, N>& array_) noexcept
+    {
+        static_assert(detail::is_serializable_v<std::remove_const_t<T>>, "Elements must be trivially copyable");
+        return detail::make_byte_wrapper<const unsigned char, detail::byte_extent<T, N>>(
+            reinterpret_cast<const unsigned char*>(array_.data()), array_.size() * sizeof(T));
+    }
+
+    // e.g. for read() straight into the elements
+    template <typename T, size_t N>
+    inline Array_Wrapper<unsigned char, detail::byte_extent<T, N>> as_writable_bytes(Array_Wrapper<T, N> array_) noexcept
+    {
+        static_assert(!std::is_const_v<T>, "Elements must be writable");
+        static_assert(detail::is_serializable_v<T>, "Elements must be trivially copyable");
+        return detail::make_byte_wrapper<unsigned char, detail::byte_extent<T, N>>(
+            reinterpret_cast<unsigned char*>(array_.data()), array_.size() * sizeof(T));
+    }
+
+    // Wraps a received buffer in place as elements of T without copying. The buffer has to be aligned for
+    // T and hold exactly as many whole elements as fit, N of them for a fixed size.
+    template <typename T, size_t N = dynamic_extent, typename Byte, size_t M>
+    inline Array_Wrapper<T, N> from_bytes(Array_Wrapper<Byte, M> bytes_)
+    {
+        detail::check_decoded(bytes_.size() % sizeof(T) != 0, "Buffer size is not a multiple of the element size: ", bytes_.size());
+        return detail::wrap_bytes<T, N>(bytes_, bytes_.size() / sizeof(T));
+    }
+
+    /* BYTE ORDER */
+    // reverses the byte order of every element in place
+    template <typename T, size_t N>
+    inline void byteswap(Array_Wrapper<T, N> array_) noexcept
+    {
+        static_assert(!std::is_const_v<T>, "Elements must be writable");
+        static_assert(detail::is_byte_swappable_v<T>, "Elements must be integers, enums or floating point");
+
+        if constexpr (sizeof(T) > 1)
+        {
+            detail::swap_byte_order<sizeof(T)>(reinterpret_cast<unsigned char*>(array_.data()), array_.size());
+        }
+    }
+
+    // converts the elements in place from one byte order to the other, nothing happens if they are the same
+    template <typename T, size_t N>
+    inline void convert_endian(Array_Wrapper<T, N> array_, Endian from, Endian to = Endian::Native) noexcept
+    {
+        if (from != to) { byteswap(array_); }
+    }
+
+    /* An Array_Header is a 16 byte prefix describing serialized elements, so that a receiver can check
+       what it got before wrapping it. All fields are little endian:
+           bytes 0-3   magic "FIBB"
+           byte  4     format version
+           byte  5     flags, bit 0 is set if the payload is big endian
+           bytes 6-7   element size
+           bytes 8-15  element count
+       The payload follows immediately, a buffer aligned to 16 bytes keeps it aligned for any element
+       up to that size. */
+
+    class Array_Header
+    {
+        public:
+            static constexpr size_t size_bytes = 16;
+            static constexpr unsigned char current_version = 1;
+
+            Array_Header(size_t element_size_, std::uint64_t count_, Endian payload_endian_ = Endian::Native)
+                : m_bytes{'F', 'I', 'B', 'B', current_version,
+                    static_cast<unsigned char>(payload_endian_ == Endian::Big ? 1 : 0)}
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(element_size_ > 0xFFFF))
+                {
+                    detail::raise_invalid_argument("Element size too large for a header: ", element_size_);
+                }
+                store(6, element_size_, 2);
+                store(8, count_, 8);
+            }
+
+            // reads and validates a header from the start of a buffer
+            template <typename Byte, size_t M>
+            static Array_Header parse(const Array_Wrapper<Byte, M>& bytes_)
+            {
+                detail::check_decoded(bytes_.size() < size_bytes, "Buffer too small for a header: ", bytes_.size());
+
+                Array_Header header;
+                std::memcpy(header.m_bytes, bytes_.data(), size_bytes);
+                detail::check_decoded(std::memcmp(header.m_bytes, "FIBB", 4) != 0, "Not an array header at: ",
+                    reinterpret_cast<std::uintptr_t>(bytes_.data()));
+                detail::check_decoded(header.version() != current_version, "Unsupported header version: ", header.version());
+                return header;
+            }
+
+            unsigned char version() const noexcept { return m_bytes[4]; }
+            Endian payload_endian() const noexcept { return (m_bytes[5] & 1) != 0 ? Endian::Big : Endian::Little; }
+            size_t element_size() const noexcept { return static_cast<size_t>(load(6, 2)); }
+            std::uint64_t count() const noexcept { return load(8, 8); }
+
+            const unsigned char* data() const noexcept { return m_bytes; }
+            constexpr size_t size() const noexcept { return size_bytes; }
+
+        private:
+            unsigned char m_bytes[size_bytes] = {};
+
+            Array_Header() noexcept = default;
+
+            void store(size_t pos, std::uint64_t value, size_t width) noexcept
+            {
+                for (size_t i = 0; i < width; ++i) { m_bytes[pos + i] = static_cast<unsigned char>(value >> (8 * i)); }
+            }
+
+            std::uint64_t load(size_t pos, size_t width) const noexcept
+            {
+                std::uint64_t value = 0;
+                for (size_t i = 0; i < width; ++i) { value |= static_cast<std::uint64_t>(m_bytes[pos + i]) << (8 * i); }
+                return value;
+            }
+    };
+
+    template <typename T, size_t N>
+    inline Array_Header make_header(const Array_Wrapper<T, N>& array_, Endian payload_endian_ = Endian::Native)
+    {
+        static_assert(detail::is_serializable_v<std::remove_const_t<T>>, "Elements must be trivially copyable");
+        return Array_Header(sizeof(T), array_.size(), payload_endian_);
+    }
+
+    // Validates the header at the start of a received buffer and wraps the payload after it in place.
+    // A payload in the other byte order is swapped in place, which needs a writable buffer.
+    template <typename T, size_t N = dynamic_extent, typename Byte, size_t M>
+    inline Array_Wrapper<T, N> deserialize(Array_Wrapper<Byte, M> bytes_)
+    {
+        const Array_Header header = Array_Header::parse(bytes_);
+        detail::check_decoded(header.element_size() != sizeof(T), "Unexpected element size: ", header.element_size());
+
+        const Array_Wrapper<Byte, dynamic_extent> payload(bytes_.data() + Array_Header::size_bytes,
+            bytes_.size() - Array_Header::size_bytes);
+        detail::check_decoded(header.count() > payload.size() / sizeof(T), "Buffer too small for elements: ",
+            static_cast<size_t>(header.count()));
+
+        const Array_Wrapper<T, N> result = detail::wrap_bytes<T, N>(payload, static_cast<size_t>(header.count()));
+        if (header.payload_endian() != Endian::Native && sizeof(T) > 1)
+        {
+            if constexpr (std::is_const_v<Byte> || !detail::is_byte_swappable_v<std::remove_const_t<T>>)
+            {
+                detail::raise_invalid_argument("Payload byte order can't be converted in place, element size: ", sizeof(T));
+            }
+            else
+            {
+                using element_type = std::remove_const_t<T>;
+                byteswap(Array_Wrapper<element_type, dynamic_extent>(const_cast<element_type*>(result.data()), result.size()));
+            }
+        }
+        return result;
+    }
+
+#if defined(FIBB_ARRAY_WRAPPER_IOVEC)
+    /* SCATTER / GATHER */
+    // Describes a wrapper or header for writev() and readv(), e.g. sending a header and its payload
+    // with one call and no copy:  auto parts = fibb::to_iovecs(header, frame);  writev(fd, parts.data(), 2);
+    template <typename T, size_t N>
+    inline ::iovec to_iovec(const Array_Wrapper<T, N>& array_) noexcept
+    {
+        static_assert(detail::is_serializable_v<std::remove_const_t<T>>, "Elements must be trivially copyable");
+        return ::iovec{const_cast<std::remove_const_t<T>*>(array_.data()), array_.size() * sizeof(T)};
+    }
+
+    inline ::iovec to_iovec(const Array_Header& header) noexcept
+    {
+        return ::iovec{const_cast<unsigned char*>(header.data()), header.size()};
+    }
+
+    template <typename... Parts>
+    inline std::array<::iovec, sizeof...(Parts)> to_iovecs(const Parts&... parts) noexcept
+    {
+        return {to_iovec(parts)...};
+    }
+#endif
+}
+
+#endif
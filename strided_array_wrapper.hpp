@@ -0,0 +1,359 @@
+#ifndef FIBB_STRIDED_ARRAY_WRAPPER
+#define FIBB_STRIDED_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+namespace fibb
+{
+    // as a template argument the stride is given at runtime instead
+    inline constexpr size_t dynamic_stride = dynamic_extent;
+
+    // runtime strides can be given in either unit, compile time strides are always in bytes
+    struct Byte_Stride { size_t bytes; };
+    struct Element_Stride { size_t elements; };
+
+    namespace detail
+    {
+        // a fixed stride costs no storage, see Extent
+        template <size_t Stride>
+        class Stride_Storage
+        {
+            public:
+                constexpr explicit Stride_Storage(size_t) noexcept {}
+                static constexpr size_t stride() noexcept { return Stride; }
+        };
+
+        template <>
+        class Stride_Storage<dynamic_stride>
+        {
+            public:
+                constexpr explicit Stride_Storage(size_t stride_) noexcept : m_stride(stride_) {}
+                constexpr size_t stride() const noexcept { return m_stride; }
+
+            private:
+                size_t m_stride;
+        };
+
+        template <typename T>
+        using byte_pointer_for = std::conditional_t<std::is_const_v<T>, const unsigned char*, unsigned char*>;
+
+        // pointer arithmetic in bytes, strides need not be a multiple of sizeof(T)
+        template <typename T>
+        inline T* advance_bytes(T* ptr, ptrdiff_t bytes) noexcept
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<byte_pointer_for<T>>(ptr) + bytes);
+        }
+    }
+
+    /* Random access iterator over elements Stride bytes apart */
+
+    template <typename T, size_t Stride>
+    class Strided_Iterator : private detail::Stride_Storage<Stride>
+    {
+        private:
+            using stride_type = detail::Stride_Storage<Stride>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_cv_t<T>;
+            using difference_type = ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            Strided_Iterator() noexcept : stride_type(0), m_ptr(nullptr) {}
+            Strided_Iterator(pointer ptr_, size_t stride_) noexcept : stride_type(stride_), m_ptr(ptr_) {}
+
+            // iterator to const_iterator
+            template <typename U, std::enable_if_t<std::is_same_v<const U, T>, int> = 0>
+            Strided_Iterator(const Strided_Iterator<U, Stride>& other) noexcept
+                : stride_type(other.stride()), m_ptr(other.base())
+            {}
+
+            reference operator*() const noexcept { return *m_ptr; }
+            pointer operator->() const noexcept { return m_ptr; }
+            reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+            Strided_Iterator& operator++() noexcept { return *this += 1; }
+            Strided_Iterator& operator--() noexcept { return *this -= 1; }
+            Strided_Iterator operator++(int) noexcept { Strided_Iterator tmp = *this; ++*this; return tmp; }
+            Strided_Iterator operator--(int) noexcept { Strided_Iterator tmp = *this; --*this; return tmp; }
+
+            Strided_Iterator& operator+=(difference_type n) noexcept
+            {
+                m_ptr = detail::advance_bytes(m_ptr, n * static_cast<difference_type>(stride()));
+                return *this;
+            }
+
+            Strided_Iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+            friend Strided_Iterator operator+(Strided_Iterator it, difference_type n) noexcept { return it += n; }
+            friend Strided_Iterator operator+(difference_type n, Strided_Iterator it) noexcept { return it += n; }
+            friend Strided_Iterator operator-(Strided_Iterator it, difference_type n) noexcept { return it -= n; }
+
+            friend difference_type operator-(const Strided_Iterator& a, const Strided_Iterator& b) noexcept
+            {
+                using byte_pointer = detail::byte_pointer_for<T>;
+                return (reinterpret_cast<byte_pointer>(a.m_ptr) - reinterpret_cast<byte_pointer>(b.m_ptr))
+                    / static_cast<difference_type>(a.stride());
+            }
+
+            friend bool operator==(const Strided_Iterator& a, const Strided_Iterator& b) noexcept { return a.m_ptr == b.m_ptr; }
+            friend bool operator!=(const Strided_Iterator& a, const Strided_Iterator& b) noexcept { return a.m_ptr != b.m_ptr; }
+            friend bool operator<(const Strided_Iterator& a, const Strided_Iterator& b) noexcept { return a.m_ptr < b.m_ptr; }
+            friend bool operator>(const Strided_Iterator& a, const Strided_Iterator& b) noexcept { return a.m_ptr > b.m_ptr; }
+            friend bool operator<=(const Strided_Iterator& a, const Strided_Iterator& b) noexcept { return a.m_ptr <= b.m_ptr; }
+            friend bool operator>=(const Strided_Iterator& a, const Strided_Iterator& b) noexcept { return a.m_ptr >= b.m_ptr; }
+
+            using stride_type::stride;
+            pointer base() const noexcept { return m_ptr; }
+
+        private:
+            pointer m_ptr;
+    };
+
+    /* The Strided_Array_Wrapper views N elements which are Stride bytes apart, such as one field
+       of an array of structs or one channel of interleaved audio. It offers the same std::array
+       like interface as Array_Wrapper through random access iterators.
+
+       Strides are in bytes so that a field can be viewed even when the size of the enclosing struct
+       is not a multiple of sizeof(T). A runtime stride must not be zero and a byte stride must be a
+       multiple of alignof(T), otherwise construction throws std::invalid_argument.
+
+       gather() copies the elements into a contiguous Array_Wrapper, e.g. scratch space for SIMD
+       processing, and scatter() writes them back.
+
+       As with Array_Wrapper the underlying array must exist for the lifetime of the wrapper and
+       assignment copies elements rather than rebinding the view. */
+
+    template <typename T, size_t N, size_t Stride = dynamic_stride>
+    class Strided_Array_Wrapper : private detail::Extent<N>, private detail::Stride_Storage<Stride>
+    {
+        private:
+            using extent_type = detail::Extent<N>;
+            using stride_type = detail::Stride_Storage<Stride>;
+
+        public:
+            /* TYPES */
+            using value_type = std::remove_cv_t<T>;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using reference = T&;
+            using const_reference = const T&;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using iterator = Strided_Iterator<T, Stride>;
+            using const_iterator = Strided_Iterator<const T, Stride>;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+            using contiguous_type = Array_Wrapper<value_type, N>;
+
+            static constexpr size_type extent = N;
+
+            /* CONSTRUCTORS */
+            template <size_t M = N, size_t S = Stride,
+                std::enable_if_t<M != dynamic_extent && S != dynamic_stride, int> = 0>
+            Strided_Array_Wrapper(pointer first_) // pointer to the first element, size and stride known at compile time
+                : extent_type(N), stride_type(Stride), m_first(first_)
+            {}
+
+            template <size_t M = N, size_t S = Stride,
+                std::enable_if_t<M != dynamic_extent && S == dynamic_stride, int> = 0>
+            Strided_Array_Wrapper(pointer first_, Byte_Stride stride_)
+                : extent_type(N), stride_type(checked_stride(stride_.bytes)), m_first(first_)
+            {}
+
+            template <size_t M = N, size_t S = Stride,
+                std::enable_if_t<M != dynamic_extent && S == dynamic_stride, int> = 0>
+            Strided_Array_Wrapper(pointer first_, Element_Stride stride_)
+                : extent_type(N), stride_type(checked_stride(stride_.elements * sizeof(T))), m_first(first_)
+            {}
+
+            template <size_t M = N, size_t S = Stride,
+                std::enable_if_t<M == dynamic_extent && S != dynamic_stride, int> = 0>
+            Strided_Array_Wrapper(pointer first_, size_type size_) noexcept
+                : extent_type(size_), stride_type(Stride), m_first(first_)
+            {}
+
+            template <size_t M = N, size_t S = Stride,
+                std::enable_if_t<M == dynamic_extent && S == dynamic_stride, int> = 0>
+            Strided_Array_Wrapper(pointer first_, size_type size_, Byte_Stride stride_)
+                : extent_type(size_), stride_type(checked_stride(stride_.bytes)), m_first(first_)
+            {}
+
+            template <size_t M = N, size_t S = Stride,
+                std::enable_if_t<M == dynamic_extent && S == dynamic_stride, int> = 0>
+            Strided_Array_Wrapper(pointer first_, size_type size_, Element_Stride stride_)
+                : extent_type(size_), stride_type(checked_stride(stride_.elements * sizeof(T))), m_first(first_)
+            {}
+
+            // one field of a sized array of structs
+            template <typename S, size_t M, std::enable_if_t<M == N || N == dynamic_extent, int> = 0>
+            Strided_Array_Wrapper(S (&array_)[M], value_type S::* member)
+                : extent_type(M), stride_type(sizeof(S)), m_first(&(array_[0].*member))
+            {
+                static_assert(Stride == dynamic_stride || Stride == sizeof(S));
+            }
+
+            // copying a wrapper copies the pointer, assigning one copies the elements
+            Strided_Array_Wrapper(const Strided_Array_Wrapper&) = default;
+
+            /* COMPARISON */
+            bool operator==(const Strided_Array_Wrapper& other) const noexcept
+            {
+                return std::equal(begin(), end(), other.begin(), other.end());
+            }
+
+            bool operator!=(const Strided_Array_Wrapper& other) const noexcept { return !(*this == other); }
+
+            bool operator<(const Strided_Array_Wrapper& other) const noexcept
+            {
+                return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+            }
+
+            bool operator>(const Strided_Array_Wrapper& other) const noexcept { return other < *this; }
+            bool operator<=(const Strided_Array_Wrapper& other) const noexcept { return !(other < *this); }
+            bool operator>=(const Strided_Array_Wrapper& other) const noexcept { return !(*this < other); }
+
+            /* ASSIGNMENT */
+            // copy assignment will copy elements into the underlying array
+            // wrappers over interleaved fields of the same array never overlap so there is no alias check beyond identity
+            Strided_Array_Wrapper& operator=(const Strided_Array_Wrapper& other)
+                noexcept(std::is_nothrow_copy_assignable_v<value_type> && N != dynamic_extent)
+            {
+                check_same_size(other.size());
+                if (m_first != other.m_first)
+                {
+                    std::copy(other.begin(), other.end(), begin());
+                }
+                return *this;
+            }
+
+            void fill(const_reference val) { std::fill_n(begin(), size(), val); }
+
+            // swaps the elements, not the pointers
+            void swap(Strided_Array_Wrapper& other)
+                noexcept(std::is_nothrow_swappable_v<value_type> && N != dynamic_extent)
+            {
+                check_same_size(other.size());
+                if (m_first != other.m_first)
+                {
+                    std::swap_ranges(begin(), end(), other.begin());
+                }
+            }
+
+            /* GATHER / SCATTER */
+            // With a compile time stride the loops index with a constant stride which compilers vectorize
+            void gather(contiguous_type dest) const
+            {
+                check_same_size(dest.size());
+                for (size_type i = 0; i < size(); ++i) { dest[i] = (*this)[i]; }
+            }
+
+            void scatter(const contiguous_type& src)
+            {
+                check_same_size(src.size());
+                for (size_type i = 0; i < size(); ++i) { (*this)[i] = src[i]; }
+            }
+
+            /* ITERATORS */
+            iterator begin() noexcept { return iterator(m_first, stride()); }
+            const_iterator begin() const noexcept { return const_iterator(m_first, stride()); }
+            const_iterator cbegin() const noexcept { return begin(); }
+
+            iterator end() noexcept { return begin() + static_cast<difference_type>(size()); }
+            const_iterator end() const noexcept { return begin() + static_cast<difference_type>(size()); }
+            const_iterator cend() const noexcept { return end(); }
+
+            reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+            const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+            reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+            const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+            /* CAPACITY */
+            constexpr size_type size() const noexcept { return extent_type::size(); }
+            constexpr size_type max_size() const noexcept { return size(); }
+            constexpr bool empty() const noexcept { return size() == 0; }
+
+            // distance between elements in bytes
+            constexpr size_type stride() const noexcept { return stride_type::stride(); }
+
+            /* ELEMENT ACCESS */
+            reference operator[](size_type pos) noexcept
+            {
+                detail::check_access(pos, size());
+                return *element(pos);
+            }
+
+            const_reference operator[](size_type pos) const noexcept
+            {
+                detail::check_access(pos, size());
+                return *element(pos);
+            }
+
+            reference at(size_type pos)
+            {
+                const Strided_Array_Wrapper& const_this = *this;
+                return const_cast<reference>(const_this.at(pos));
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size())) { detail::raise_range_error(pos); }
+
+                return *element(pos);
+            }
+
+            reference front() noexcept { return (*this)[0]; }
+            const_reference front() const noexcept { return (*this)[0]; }
+            reference back() noexcept { return (*this)[size() - 1]; }
+            const_reference back() const noexcept { return (*this)[size() - 1]; }
+
+            // pointer to the first element, the rest are not contiguous
+            pointer data() noexcept { return m_first; }
+            const_pointer data() const noexcept { return m_first; }
+
+        private:
+            pointer m_first;
+
+            pointer element(size_type pos) const noexcept
+            {
+                return detail::advance_bytes(m_first, static_cast<difference_type>(pos * stride()));
+            }
+
+            // a zero stride would make every iterator equal to begin(), so end() could never be reached
+            static size_type checked_stride(size_type bytes)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(bytes == 0))
+                {
+                    detail::raise_invalid_argument("Zero stride: ", bytes);
+                }
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(bytes % alignof(T) != 0))
+                {
+                    detail::raise_invalid_argument("Misaligned stride: ", bytes);
+                }
+                return bytes;
+            }
+
+            void check_same_size(size_type other_size) const
+            {
+                if constexpr (N == dynamic_extent)
+                {
+                    if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(other_size != size())) { detail::raise_length_error(size(), other_size); }
+                }
+            }
+
+            static_assert(Stride == dynamic_stride || (Stride != 0 && Stride % alignof(T) == 0));
+    };
+
+    template <typename S, size_t N, typename T>
+    Strided_Array_Wrapper(S (&)[N], T S::*) -> Strided_Array_Wrapper<T, N, sizeof(S)>;
+
+    // compile time stride in elements rather than bytes
+    template <typename T, size_t N, size_t Stride_Elements>
+    using Element_Strided_Array_Wrapper = Strided_Array_Wrapper<T, N, Stride_Elements * sizeof(T)>;
+}
+
+#endif // FIBB_STRIDED_ARRAY_WRAPPER
@@ -0,0 +1,206 @@
+#include "algorithm_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+// every search result is compared against the standard algorithm for each value from below the
+// smallest element to above the largest
+
+template <typename T, size_t N>
+static void check_searches(fibb::Array_Wrapper<T, N> array_)
+{
+    const T* first = array_.data();
+    const T* last = first + array_.size();
+    const int low = array_.empty() ? 0 : static_cast<int>(*first) - 1;
+    const int high = array_.empty() ? 0 : static_cast<int>(*(last - 1)) + 1;
+    for (int v = low; v <= high; ++v)
+    {
+        const T value = static_cast<T>(v);
+        FIBB_CHECK(fibb::lower_bound(array_, value) == std::lower_bound(first, last, value));
+        FIBB_CHECK(fibb::upper_bound(array_, value) == std::upper_bound(first, last, value));
+        FIBB_CHECK(fibb::binary_search(array_, value) == std::binary_search(first, last, value));
+
+        const auto& read_only = array_;
+        FIBB_CHECK(fibb::binary_search(read_only, value) == std::binary_search(first, last, value));
+    }
+}
+
+static void test_fixed_searches()
+{
+    int a[4] = {1, 3, 3, 7};
+    check_searches(fibb::Array_Wrapper<int, 4>(a));
+
+    int one[1] = {5};
+    check_searches(fibb::Array_Wrapper<int, 1>(one));
+
+    const int c[5] = {-2, 0, 0, 0, 9};
+    check_searches(fibb::Array_Wrapper<const int, 5>(c));
+
+    // descending order with a custom comparison
+    int d[4] = {7, 3, 3, 1};
+    fibb::Array_Wrapper<int, 4> descending(d);
+    for (int v = 0; v <= 8; ++v)
+    {
+        FIBB_CHECK(fibb::lower_bound(descending, v, std::greater<>()) == std::lower_bound(d, d + 4, v, std::greater<>()));
+        FIBB_CHECK(fibb::upper_bound(descending, v, std::greater<>()) == std::upper_bound(d, d + 4, v, std::greater<>()));
+        FIBB_CHECK(fibb::binary_search(descending, v, std::greater<>()) == std::binary_search(d, d + 4, v, std::greater<>()));
+    }
+}
+
+static void test_dynamic_searches()
+{
+    std::mt19937 random(1);
+    for (size_t n = 0; n <= 70; ++n)
+    {
+        std::vector<int> v(n);
+        for (int& x : v) { x = static_cast<int>(random() % 40); }
+        std::sort(v.begin(), v.end());
+        check_searches(fibb::Array_Wrapper<int, fibb::dynamic_extent>(v.data(), n));
+    }
+}
+
+static void test_find()
+{
+    std::vector<int> v(100);
+    for (size_t i = 0; i < v.size(); ++i) { v[i] = static_cast<int>(i % 37); }
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> array_(v.data(), v.size());
+    for (int x = -1; x <= 37; ++x) { FIBB_CHECK(fibb::find(array_, x) == std::find(v.data(), v.data() + v.size(), x)); }
+}
+
+static void test_eytzinger()
+{
+    std::mt19937 random(2);
+    for (size_t n = 0; n <= 100; ++n)
+    {
+        std::vector<int> sorted(n);
+        for (int& x : sorted) { x = static_cast<int>(random() % 60); }
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<int> layout(n);
+        fibb::eytzinger_layout(fibb::Array_Wrapper<int, fibb::dynamic_extent>(layout.data(), n),
+            fibb::Array_Wrapper<const int, fibb::dynamic_extent>(sorted.data(), n));
+
+        // the layout holds the same elements
+        std::vector<int> elements = layout;
+        std::sort(elements.begin(), elements.end());
+        FIBB_CHECK(elements == sorted);
+
+        const fibb::Array_Wrapper<int, fibb::dynamic_extent> tree(layout.data(), n);
+        for (int v = -1; v <= 61; ++v)
+        {
+            const size_t expected = static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), v) - sorted.begin());
+            const size_t found = fibb::eytzinger_lower_bound(tree, v);
+            if (expected == n) { FIBB_CHECK(found == n); }
+            else { FIBB_CHECK(found < n && layout[found] == sorted[expected]); }
+        }
+    }
+}
+
+// sorts every fixed size the networks cover with random keys, including runs of equal keys
+template <size_t N>
+static void check_network_sort(std::mt19937& random)
+{
+    for (int round = 0; round < 200; ++round)
+    {
+        int a[N];
+        for (int& x : a) { x = static_cast<int>(random() % (round % 2 == 0 ? 4 : 1000)) - 2; }
+        std::vector<int> expected(a, a + N);
+        std::sort(expected.begin(), expected.end());
+        fibb::sort(fibb::Array_Wrapper<int, N>(a));
+        FIBB_CHECK(std::equal(a, a + N, expected.begin()));
+
+        double d[N];
+        for (double& x : d) { x = static_cast<double>(random() % 100) / 8; }
+        std::vector<double> descending(d, d + N);
+        std::sort(descending.begin(), descending.end(), std::greater<>());
+        fibb::sort(fibb::Array_Wrapper<double, N>(d), std::greater<>());
+        FIBB_CHECK(std::equal(d, d + N, descending.begin()));
+    }
+}
+
+template <size_t... N>
+static void test_network_sorts(std::index_sequence<N...>)
+{
+    std::mt19937 random(3);
+    (check_network_sort<N + 1>(random), ...);
+}
+
+static void test_dynamic_sort()
+{
+    std::mt19937 random(4);
+    for (size_t n : {0, 1, 2, 17, 100, 1000})
+    {
+        std::vector<int> v(n);
+        for (int& x : v) { x = static_cast<int>(random() % 50); }
+        std::vector<int> expected = v;
+        std::sort(expected.begin(), expected.end());
+        fibb::sort(fibb::Array_Wrapper<int, fibb::dynamic_extent>(v.data(), n));
+        FIBB_CHECK(v == expected);
+    }
+
+    // fixed sizes past the network limit fall back to std::sort
+    int a[40];
+    for (int& x : a) { x = static_cast<int>(random() % 10); }
+    fibb::sort(fibb::Array_Wrapper<int, 40>(a));
+    FIBB_CHECK(std::is_sorted(a, a + 40));
+}
+
+template <typename T>
+static void check_radix_sort(std::mt19937_64& random)
+{
+    for (size_t n : {0, 1, 2, 3, 255, 256, 1000, 5000})
+    {
+        std::vector<T> v(n);
+        for (T& x : v) { x = static_cast<T>(random()); }
+        if (n > 2) { v[1] = std::numeric_limits<T>::min(); v[2] = std::numeric_limits<T>::max(); }
+        std::vector<T> expected = v;
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<T> scratch(n);
+        fibb::radix_sort(fibb::Array_Wrapper<T, fibb::dynamic_extent>(v.data(), n),
+            fibb::Array_Wrapper<T, fibb::dynamic_extent>(scratch.data(), n));
+        FIBB_CHECK(v == expected);
+    }
+
+    // keys sharing their high bytes, which skips those passes
+    std::vector<T> v(300);
+    for (T& x : v) { x = static_cast<T>(random() % 100); }
+    std::vector<T> expected = v;
+    std::sort(expected.begin(), expected.end());
+    std::vector<T> scratch(v.size());
+    fibb::radix_sort(fibb::Array_Wrapper<T, fibb::dynamic_extent>(v.data(), v.size()),
+        fibb::Array_Wrapper<T, fibb::dynamic_extent>(scratch.data(), scratch.size()));
+    FIBB_CHECK(v == expected);
+}
+
+static void test_radix_sort()
+{
+    std::mt19937_64 random(5);
+    check_radix_sort<std::uint8_t>(random);
+    check_radix_sort<std::int16_t>(random);
+    check_radix_sort<std::int32_t>(random);
+    check_radix_sort<std::uint32_t>(random);
+    check_radix_sort<std::int64_t>(random);
+    check_radix_sort<std::uint64_t>(random);
+
+    // fixed size with an exactly sized scratch buffer
+    std::int32_t a[8] = {5, -1, 7, -300000, 0, 2, 2, 1};
+    std::int32_t scratch[8];
+    fibb::radix_sort(fibb::Array_Wrapper<std::int32_t, 8>(a), fibb::Array_Wrapper<std::int32_t, 8>(scratch));
+    FIBB_CHECK(std::is_sorted(a, a + 8) && a[0] == -300000 && a[7] == 7);
+}
+
+int main()
+{
+    test_fixed_searches();
+    test_dynamic_searches();
+    test_find();
+    test_eytzinger();
+    test_network_sorts(std::make_index_sequence<FIBB_ARRAY_WRAPPER_SORT_NETWORK_LIMIT>());
+    test_dynamic_sort();
+    test_radix_sort();
+}
@@ -0,0 +1,79 @@
+#include "aligned_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+// the accessors stay usable in constant expressions, where the alignment can't be checked or assumed
+constexpr int sum_of_squares()
+{
+    alignas(32) int a[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    fibb::Aligned_Array_Wrapper<int, 8, 32> w(a);
+    w[0] = 10;
+    int sum = 0;
+    for (int x : w) { sum += x * x; }
+    return sum + (w.end() - w.begin()) + *w.data();
+}
+
+static_assert(sum_of_squares() == 100 + 140 + 8 + 10);
+
+static void test_access()
+{
+    alignas(64) float a[16];
+    std::iota(a, a + 16, 0.0f);
+    fibb::Aligned_Array_Wrapper<float, 16, 64> w(a);
+    FIBB_CHECK(w.data() == a && w.begin() == a && w.end() == a + 16 && w[15] == 15);
+
+    const auto& read_only = w;
+    FIBB_CHECK(read_only.cbegin() == a && read_only[3] == 3 && read_only.alignment == 64);
+
+    alignas(16) double b[6] = {};
+    fibb::Aligned_Array_Wrapper<double, fibb::dynamic_extent, 16> dyn(b, 6);
+    FIBB_CHECK(dyn.size() == 6 && dyn.end() - dyn.begin() == 6);
+
+    // adopting a plain wrapper and converting back keep the elements
+    const fibb::Array_Wrapper<float, 16> wrapped(a);
+    fibb::Aligned_Array_Wrapper<float, 16, 64> adopted(wrapped);
+    const fibb::Array_Wrapper<float, fibb::dynamic_extent> plain = adopted.subspan(1);
+    FIBB_CHECK(adopted.data() == a && plain.data() == a + 1);
+}
+
+static void test_misaligned()
+{
+    alignas(64) int a[17] = {};
+    int* offset = a + 1;
+    FIBB_CHECK_THROWS((fibb::Aligned_Array_Wrapper<int, 16, 64>(offset)), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::Aligned_Array_Wrapper<int, fibb::dynamic_extent, 64>(a + 1, 16)), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::Aligned_Array_Wrapper<int, fibb::dynamic_extent, 64>(fibb::Array_Wrapper<int, fibb::dynamic_extent>(a + 1, 16))),
+        std::invalid_argument);
+}
+
+static void test_fill_and_assign()
+{
+    alignas(32) int a[9] = {};
+    alignas(32) int b[9];
+    fibb::Aligned_Array_Wrapper<int, 9, 32> x(a);
+    fibb::Aligned_Array_Wrapper<int, 9, 32> y(b);
+
+    // a byte pattern and a value which isn't one take different paths
+    y.fill(-1);
+    FIBB_CHECK(b[0] == -1 && b[8] == -1);
+    y.fill(7);
+    FIBB_CHECK(b[0] == 7 && b[8] == 7);
+
+    x = y;
+    FIBB_CHECK(a[0] == 7 && a[8] == 7 && x == y);
+
+    alignas(64) std::string s[3];
+    fibb::Aligned_Array_Wrapper<std::string, 3, 64> strings(s);
+    strings.fill("aligned");
+    FIBB_CHECK(s[0] == "aligned" && s[2] == "aligned");
+}
+
+int main()
+{
+    test_access();
+    test_misaligned();
+    test_fill_and_assign();
+}
@@ -0,0 +1,146 @@
+#include "arena_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    bool is_aligned(const void* ptr, size_t alignment)
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+    }
+
+    struct alignas(32) Vector
+    {
+        float lanes[8];
+    };
+}
+
+static void test_arena_arrays()
+{
+    fibb::Arena arena(1024);
+    auto samples = arena.make<float, 16>();
+    auto indices = arena.make<std::uint32_t>(10, 7);
+    auto flags = arena.make<bool, 3>(true);
+    auto vectors = arena.make<Vector>(2);
+    static_assert(std::is_same_v<decltype(samples), fibb::Array_Wrapper<float, 16>>);
+    static_assert(std::is_same_v<decltype(indices), fibb::Array_Wrapper<std::uint32_t, fibb::dynamic_extent>>);
+
+    FIBB_CHECK(indices.size() == 10 && indices[0] == 7 && indices[9] == 7);
+    FIBB_CHECK(flags[0] && flags[2] && vectors.size() == 2);
+    FIBB_CHECK(is_aligned(samples.data(), alignof(std::max_align_t)) && is_aligned(vectors.data(), 32));
+
+    // arrays made in a row are contiguous, give or take alignment padding
+    const auto* first_byte = reinterpret_cast<const unsigned char*>(samples.data());
+    FIBB_CHECK(reinterpret_cast<const unsigned char*>(indices.data()) == first_byte + sizeof(float) * 16);
+
+    samples.fill(1.5f);
+    FIBB_CHECK(indices[0] == 7 && samples[15] == 1.5f);
+    FIBB_CHECK(arena.capacity() == 1024);
+
+    // a coarser arena wide alignment applies to every array
+    fibb::Arena aligned(1024, 64);
+    auto a = aligned.make<char, 1>();
+    auto b = aligned.make<char, 1>();
+    FIBB_CHECK(is_aligned(a.data(), 64) && b.data() == a.data() + 64);
+}
+
+static void test_arena_blocks()
+{
+    fibb::Arena arena(256);
+    const auto first = arena.make<std::uint8_t, 200>();
+    const auto second = arena.make<std::uint8_t, 200>();
+    FIBB_CHECK(arena.capacity() == 512 && second.data() != first.data() + 200);
+
+    // a request larger than a block gets one of its own
+    const auto large = arena.make<std::uint8_t>(1000);
+    FIBB_CHECK(arena.capacity() == 1512 && large.size() == 1000);
+
+    // reset reuses the blocks in order without allocating
+    arena.reset();
+    const auto again = arena.make<std::uint8_t, 200>();
+    const auto again_second = arena.make<std::uint8_t, 200>();
+    FIBB_CHECK(again.data() == first.data() && again_second.data() == second.data() && arena.capacity() == 1512);
+
+    fibb::Arena moved(std::move(arena));
+    FIBB_CHECK(moved.capacity() == 1512);
+    moved.release();
+    FIBB_CHECK(moved.capacity() == 0);
+    FIBB_CHECK(moved.make<int>(4).size() == 4);
+}
+
+static void test_arena_errors()
+{
+    FIBB_CHECK_THROWS(fibb::Arena(1024, 0), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::Arena(1024, 24), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::Arena(1024, 2 * FIBB_ARRAY_WRAPPER_CACHE_LINE), std::invalid_argument);
+
+    fibb::Arena arena;
+    FIBB_CHECK_THROWS(arena.allocate(8, 3), std::invalid_argument);
+    FIBB_CHECK_THROWS(arena.make<std::uint64_t>(std::numeric_limits<size_t>::max() / 4), std::length_error);
+}
+
+static void test_slab_pool_reuse()
+{
+    using Pool = fibb::Slab_Pool_For<double, 3>;
+    static_assert(Pool::alignment == alignof(std::max_align_t) && Pool::slot_size % Pool::alignment == 0 && Pool::slot_size >= 24);
+    Pool pool(4);
+
+    std::vector<fibb::Array_Wrapper<double, 3>> arrays;
+    std::set<const double*> slots;
+    for (int i = 0; i < 6; ++i)
+    {
+        arrays.push_back(pool.acquire<double, 3>());
+        arrays.back().fill(i);
+        slots.insert(arrays.back().data());
+        FIBB_CHECK(is_aligned(arrays.back().data(), pool.alignment));
+    }
+    // distinct slots which don't overlap, the first slab's in address order
+    FIBB_CHECK(slots.size() == 6 && arrays[1].data() == arrays[0].data() + pool.slot_size / sizeof(double));
+    for (int i = 0; i < 6; ++i) { FIBB_CHECK(arrays[static_cast<size_t>(i)][2] == i); }
+
+    // released slots are handed out again, most recent first
+    pool.release(arrays[4]);
+    pool.release(arrays[1]);
+    FIBB_CHECK((pool.acquire<double, 3>().data()) == arrays[1].data());
+    FIBB_CHECK((pool.acquire<double, 3>().data()) == arrays[4].data());
+
+    // smaller arrays of other types fit in a slot too, taken from the free ones
+    const auto small = pool.acquire<float, 2>();
+    FIBB_CHECK(slots.count(reinterpret_cast<const double*>(small.data())) == 0 && is_aligned(small.data(), pool.alignment));
+    pool.release(small);
+
+    // reset starts over from the first slab
+    pool.reset();
+    FIBB_CHECK((pool.acquire<double, 3>().data()) == arrays[0].data());
+
+    Pool moved(std::move(pool));
+    FIBB_CHECK((moved.acquire<double, 3>().data()) == arrays[1].data());
+}
+
+static void test_slab_pool_alignment()
+{
+    using Pool = fibb::Slab_Pool<40, 64>;
+    static_assert(Pool::slot_size == 64);
+    Pool pool(2);
+    const auto a = pool.acquire<char, 40>();
+    const auto b = pool.acquire<char, 40>();
+    const auto c = pool.acquire<char, 40>();
+    FIBB_CHECK(is_aligned(a.data(), 64) && is_aligned(b.data(), 64) && is_aligned(c.data(), 64));
+    FIBB_CHECK(b.data() == a.data() + 64);
+
+    FIBB_CHECK_THROWS((fibb::Slab_Pool<16>(0)), std::invalid_argument);
+}
+
+int main()
+{
+    test_arena_arrays();
+    test_arena_blocks();
+    test_arena_errors();
+    test_slab_pool_reuse();
+    test_slab_pool_alignment();
+}
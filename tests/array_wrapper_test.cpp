@@ -0,0 +1,376 @@
+#include "array_wrapper.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/* DYNAMIC EXTENT */
+static void test_dynamic_construction()
+{
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    fibb::Array_Wrapper dyn(v.data(), v.size());
+    static_assert(std::is_same_v<decltype(dyn), fibb::Array_Wrapper<int, fibb::dynamic_extent>>);
+    FIBB_CHECK(dyn.size() == 5 && dyn.data() == v.data() && dyn.end() == v.data() + 5);
+    FIBB_CHECK(dyn.front() == 1 && dyn.back() == 5);
+
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> empty;
+    FIBB_CHECK(empty.empty() && empty.begin() == empty.end());
+
+    int a[3] = {7, 8, 9};
+    fibb::Array_Wrapper fixed(a);
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> from_fixed = fixed;
+    fibb::Array_Wrapper<const int, fibb::dynamic_extent> read_only = fixed;
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> from_raw = a;
+    std::array<int, 2> s = {{4, 6}};
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> from_std = s;
+    FIBB_CHECK(from_fixed.size() == 3 && from_fixed.data() == a);
+    FIBB_CHECK(read_only.size() == 3 && read_only[2] == 9);
+    FIBB_CHECK(from_raw.data() == a && from_std.data() == s.data() && from_std.size() == 2);
+}
+
+// assigning a converted lvalue copies the elements and leaves the source intact
+static void test_dynamic_assignment_copies()
+{
+    std::string a[3] = {"a", "b", "c"};
+    std::string b[3];
+    fibb::Array_Wrapper<std::string, 3> fixed(a);
+    fibb::Array_Wrapper<std::string, fibb::dynamic_extent> dest(b, 3);
+
+    dest = fixed;
+    FIBB_CHECK(b[0] == "a" && b[2] == "c" && a[0] == "a" && a[2] == "c");
+
+    for (std::string& x : b) { x.clear(); }
+    dest = a;
+    FIBB_CHECK(b[1] == "b" && a[1] == "b");
+
+    std::array<std::string, 3> s = {{"x", "y", "z"}};
+    dest = s;
+    FIBB_CHECK(b[0] == "x" && b[2] == "z" && s[0] == "x" && s[2] == "z");
+
+    const fibb::Array_Wrapper<std::string, 3> const_fixed(a);
+    dest = const_fixed;
+    FIBB_CHECK(b[0] == "a" && a[0] == "a");
+
+    std::string c[3] = {"d", "e", "f"};
+    fibb::Array_Wrapper<std::string, 3> fixed_dest(c);
+    fixed_dest = a;
+    FIBB_CHECK(c[0] == "a" && a[0] == "a");
+}
+
+// wrapper rvalues still move their elements
+static void test_dynamic_move_assignment()
+{
+    std::string a[2] = {"a long string which is not stored inline", "b"};
+    std::string b[2];
+    fibb::Array_Wrapper<std::string, fibb::dynamic_extent> dest(b, 2);
+
+    dest = fibb::Array_Wrapper<std::string, fibb::dynamic_extent>(a, 2);
+    FIBB_CHECK(b[0] == "a long string which is not stored inline" && b[1] == "b");
+
+    a[0] = "c";
+    dest = fibb::Array_Wrapper<std::string, 2>(a);
+    FIBB_CHECK(b[0] == "c");
+
+    fibb::Array_Wrapper<std::string, fibb::dynamic_extent> source(a, 2);
+    a[1] = "d";
+    dest = std::move(source);
+    FIBB_CHECK(b[1] == "d");
+}
+
+static void test_dynamic_size_mismatch()
+{
+    int a[3] = {1, 2, 3};
+    int b[4] = {};
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> x(a, 3);
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> y(b, 4);
+    fibb::Array_Wrapper<int, 4> fixed(b);
+
+    FIBB_CHECK_THROWS(x = y, std::length_error);
+    FIBB_CHECK_THROWS(x = fixed, std::length_error);
+    FIBB_CHECK_THROWS(x.swap(y), std::length_error);
+    FIBB_CHECK_THROWS((fixed = fibb::Array_Wrapper<int, fibb::dynamic_extent>(a, 3)), std::length_error);
+    FIBB_CHECK(b[0] == 0 && a[0] == 1);
+
+    FIBB_CHECK(!(x == y));
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> prefix(b, 3);
+    prefix = x;
+    FIBB_CHECK(b[2] == 3 && b[3] == 0);
+    x.swap(prefix);
+    FIBB_CHECK(x == prefix);
+}
+
+/* SUB-VIEWS */
+static void test_fixed_subviews()
+{
+    int a[6] = {0, 1, 2, 3, 4, 5};
+    fibb::Array_Wrapper w(a);
+
+    auto middle = w.subview<1, 3>();
+    static_assert(std::is_same_v<decltype(middle), fibb::Array_Wrapper<int, 3>>);
+    FIBB_CHECK(middle.data() == a + 1 && middle[2] == 3);
+
+    auto tail = w.subview<4>();
+    static_assert(std::is_same_v<decltype(tail), fibb::Array_Wrapper<int, 2>>);
+    FIBB_CHECK(tail.data() == a + 4 && tail.back() == 5);
+
+    // views share the elements
+    middle[0] = 10;
+    FIBB_CHECK(a[1] == 10);
+
+    const fibb::Array_Wrapper<int, 6>& read_only = w;
+    auto const_view = read_only.subview<2, 2>();
+    static_assert(std::is_same_v<decltype(const_view), fibb::Array_Wrapper<const int, 2>>);
+    FIBB_CHECK(const_view[0] == 2);
+}
+
+static void test_runtime_subviews()
+{
+    int a[6] = {0, 1, 2, 3, 4, 5};
+    fibb::Array_Wrapper w(a);
+
+    auto head = w.first(2);
+    auto tail = w.last(2);
+    auto middle = w.subspan(1, 3);
+    auto rest = w.subspan(4);
+    FIBB_CHECK(head.data() == a && head.size() == 2);
+    FIBB_CHECK(tail.data() == a + 4 && tail.size() == 2);
+    FIBB_CHECK(middle.data() == a + 1 && middle.size() == 3);
+    FIBB_CHECK(rest.data() == a + 4 && rest.size() == 2);
+    FIBB_CHECK(w.subspan(6).empty() && w.first(0).empty() && w.last(6).size() == 6);
+
+    const auto& read_only = w;
+    static_assert(std::is_same_v<decltype(read_only.subspan(1)), fibb::Array_Wrapper<const int, fibb::dynamic_extent>>);
+    FIBB_CHECK(read_only.last(1)[0] == 5);
+
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> dyn = w;
+    auto fixed_view = dyn.subview<2, 3>();
+    static_assert(std::is_same_v<decltype(fixed_view), fibb::Array_Wrapper<int, 3>>);
+    FIBB_CHECK(fixed_view.data() == a + 2);
+    FIBB_CHECK(dyn.subview<5>().size() == 1);
+}
+
+static void test_subview_out_of_range()
+{
+    int a[6] = {};
+    fibb::Array_Wrapper w(a);
+    fibb::Array_Wrapper<int, fibb::dynamic_extent> dyn = w;
+
+    FIBB_CHECK_THROWS(w.first(7), std::out_of_range);
+    FIBB_CHECK_THROWS(w.last(7), std::out_of_range);
+    FIBB_CHECK_THROWS(w.subspan(7), std::out_of_range);
+    FIBB_CHECK_THROWS(w.subspan(2, 5), std::out_of_range);
+    // offset + count would wrap around
+    FIBB_CHECK_THROWS(w.subspan(2, fibb::dynamic_extent - 1), std::out_of_range);
+    FIBB_CHECK_THROWS((dyn.subview<4, 3>()), std::out_of_range);
+    FIBB_CHECK_THROWS(dyn.subview<7>(), std::out_of_range);
+    FIBB_CHECK_THROWS(dyn.subspan(1).subspan(4, 2), std::out_of_range);
+}
+
+/* UNROLLED SMALL WRAPPERS */
+// Fixed size wrappers up to FIBB_ARRAY_WRAPPER_UNROLL_LIMIT elements take straight-line paths, so
+// every size either side of the limit is checked against dynamic wrappers, which never unroll, and
+// against the standard algorithms.
+template <typename T, size_t N, typename Make>
+static void check_unrolled(Make make)
+{
+    std::array<T, N + 1> a, b, c;
+    for (size_t i = 0; i <= N; ++i) { a[i] = make(i); b[i] = make(i); c[i] = make(i + 1); }
+    T* pa = a.data();
+    T* pb = b.data();
+    T* pc = c.data();
+    fibb::Array_Wrapper<T, N> x(pa);
+    fibb::Array_Wrapper<T, N> y(pb);
+    fibb::Array_Wrapper<T, N> z(pc);
+    fibb::Array_Wrapper<T, fibb::dynamic_extent> dx(a.data(), N), dy(b.data(), N), dz(c.data(), N);
+
+    FIBB_CHECK((x == y) == (dx == dy) && (x == y) == std::equal(a.begin(), a.begin() + N, b.begin()));
+    FIBB_CHECK((x < z) == (dx < dz) && (x < z) == std::lexicographical_compare(a.begin(), a.begin() + N, c.begin(), c.begin() + N));
+    FIBB_CHECK((z < x) == (dz < dx) && (x != z) == (dx != dz) && (x >= z) == (dx >= dz));
+    for (size_t i = 0; i < N; ++i)
+    {
+        b[i] = make(i + 7);
+        FIBB_CHECK((x == y) == (dx == dy) && (x < y) == (dx < dy) && (y < x) == (dy < dx));
+        b[i] = make(i);
+    }
+
+    x.swap(z);
+    for (size_t i = 0; i < N; ++i) { FIBB_CHECK(a[i] == make(i + 1) && c[i] == make(i)); }
+    FIBB_CHECK(a[N] == make(N) && c[N] == make(N + 1));
+    dx.swap(dz);
+    FIBB_CHECK(std::equal(a.begin(), a.begin() + N, b.begin()));
+
+    y.fill(make(3));
+    FIBB_CHECK(std::all_of(b.begin(), b.begin() + N, [&make] (const T& v) { return v == make(3); }) && b[N] == make(N));
+
+    y = z;
+    FIBB_CHECK(std::equal(b.begin(), b.begin() + N, c.begin()) && b[N] == make(N));
+    y = std::move(x);
+    for (size_t i = 0; i < N; ++i) { FIBB_CHECK(b[i] == make(i)); a[i] = make(i); }
+
+    // views one element apart overlap everywhere but one end
+    T* shifted = pa + 1;
+    fibb::Array_Wrapper<T, N> head(pa);
+    fibb::Array_Wrapper<T, N> tail(shifted);
+    tail = head;
+    for (size_t i = 0; i < N; ++i) { FIBB_CHECK(a[i + 1] == make(i)); }
+    head = tail;
+    for (size_t i = 0; i < N; ++i) { FIBB_CHECK(a[i] == make(i)); }
+}
+
+// the unrolled paths also run in constant expressions
+constexpr int unrolled_in_constant_expression()
+{
+    int a[4] = {1, 2, 3, 4};
+    int b[4] = {};
+    fibb::Array_Wrapper x(a);
+    fibb::Array_Wrapper y(b);
+    y = x;
+    const bool copied = x == y;
+    y.fill(9);
+    x.swap(y);
+    return copied + (y < x) + a[3] + b[3];
+}
+
+static_assert(unrolled_in_constant_expression() == 1 + 1 + 9 + 4);
+
+template <typename T, typename Make, size_t... N>
+static void check_unrolled_sizes(Make make, std::index_sequence<N...>)
+{
+    (check_unrolled<T, N + 1>(make), ...);
+}
+
+static void test_unrolled_paths()
+{
+    const auto sizes = std::make_index_sequence<FIBB_ARRAY_WRAPPER_UNROLL_LIMIT + 1>();
+    check_unrolled_sizes<int>([] (size_t i) { return static_cast<int>(i) - 5; }, sizes);
+    check_unrolled_sizes<std::uint8_t>([] (size_t i) { return static_cast<std::uint8_t>(i * 40); }, sizes);
+    check_unrolled_sizes<double>([] (size_t i) { return static_cast<double>(i) * 0.5; }, sizes);
+    check_unrolled_sizes<std::string>([] (size_t i) { return std::string(i, 'x'); }, sizes);
+
+    // floating point equality isn't bytewise in either path
+    double nan[3] = {1, std::nan(""), 2};
+    double zeros[3] = {0.0, -0.0, 0.0};
+    double negative_zeros[3] = {-0.0, 0.0, -0.0};
+    const fibb::Array_Wrapper<double, 3> fixed_nan(nan);
+    const fibb::Array_Wrapper<double, fibb::dynamic_extent> dynamic_nan(nan, 3);
+    FIBB_CHECK(!(fixed_nan == fixed_nan) && !(dynamic_nan == dynamic_nan));
+    const fibb::Array_Wrapper<double, 3> fixed_zeros(zeros);
+    const fibb::Array_Wrapper<double, 3> fixed_negative_zeros(negative_zeros);
+    FIBB_CHECK(fixed_zeros == fixed_negative_zeros);
+}
+
+/* HASHING */
+template <typename T, size_t N>
+static size_t hash_of(const fibb::Array_Wrapper<T, N>& wrapper) { return std::hash<fibb::Array_Wrapper<T, N>>()(wrapper); }
+
+// every length exercises a different tail of the byte hash, so check each up to past a few blocks
+static void test_bytewise_hash()
+{
+    std::vector<std::uint8_t> a(150), b(150);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = b[i] = static_cast<std::uint8_t>(i * 37 + 11); }
+
+    for (size_t n = 0; n <= a.size(); ++n)
+    {
+        const fibb::Array_Wrapper<std::uint8_t, fibb::dynamic_extent> x(a.data(), n);
+        const fibb::Array_Wrapper<const std::uint8_t, fibb::dynamic_extent> y(b.data(), n);
+        FIBB_CHECK(hash_of(x) == hash_of(y));
+        if (n > 0)
+        {
+            b[n - 1] ^= 1;
+            FIBB_CHECK(hash_of(x) != hash_of(y));
+            b[n - 1] ^= 1;
+        }
+    }
+
+    // fixed and dynamic extent wrappers over equal elements agree
+    int c[4] = {1, 2, 3, 4};
+    const fibb::Array_Wrapper fixed(c);
+    const fibb::Array_Wrapper<int, fibb::dynamic_extent> dyn(c, 4);
+    FIBB_CHECK(hash_of(fixed) == hash_of(dyn));
+}
+
+static void test_elementwise_hash()
+{
+    // equal but not bytewise equal
+    double zeros[2] = {0.0, 1.0};
+    double negative_zeros[2] = {-0.0, 1.0};
+    const fibb::Array_Wrapper z(zeros);
+    const fibb::Array_Wrapper nz(negative_zeros);
+    FIBB_CHECK(z == nz && hash_of(z) == hash_of(nz));
+
+    std::string a[2] = {"a long string which is not stored inline", "b"};
+    std::string b[2] = {"a long string which is not stored inline", "b"};
+    const fibb::Array_Wrapper x(a);
+    const fibb::Array_Wrapper y(b);
+    FIBB_CHECK(hash_of(x) == hash_of(y));
+    b[1] = "c";
+    FIBB_CHECK(hash_of(x) != hash_of(y));
+}
+
+static void test_unordered_set_of_wrappers()
+{
+    int rows[4][3] = {{1, 2, 3}, {4, 5, 6}, {1, 2, 3}, {3, 2, 1}};
+    std::unordered_set<fibb::Array_Wrapper<const int, 3>> distinct;
+    for (const auto& row : rows) { distinct.insert(fibb::Array_Wrapper<const int, 3>(row)); }
+    FIBB_CHECK(distinct.size() == 3);
+
+    const int probe[3] = {3, 2, 1};
+    FIBB_CHECK(distinct.count(fibb::Array_Wrapper<const int, 3>(probe)) == 1);
+}
+
+// rolling the window must give the value hashing that window from scratch does
+template <typename T>
+static void check_rolling_hash(const std::vector<T>& text)
+{
+    for (size_t window = 1; window <= text.size(); ++window)
+    {
+        fibb::Rolling_Hash<T> rolling(fibb::Array_Wrapper<const T, fibb::dynamic_extent>(text.data(), window));
+        for (size_t start = 0; start + window <= text.size(); ++start)
+        {
+            if (start > 0) { rolling.roll(text[start - 1], text[start + window - 1]); }
+            const fibb::Rolling_Hash<T> fresh(fibb::Array_Wrapper<const T, fibb::dynamic_extent>(text.data() + start, window));
+            FIBB_CHECK(rolling.value() == fresh.value());
+        }
+    }
+}
+
+enum class Token : std::int16_t { a = -3, b = 0, c = 7 };
+
+static void test_rolling_hash()
+{
+    const std::string words = "the cat sat on the mat, the cat sat";
+    check_rolling_hash(std::vector<char>(words.begin(), words.end()));
+    check_rolling_hash(std::vector<std::int64_t>{-1, 5, -9000000000, 5, -1, 5, 0});
+    check_rolling_hash(std::vector<Token>{Token::a, Token::c, Token::b, Token::a, Token::c});
+
+    // equal windows hash equal wherever they are, different ones don't
+    const std::vector<char> text(words.begin(), words.end());
+    const auto window_hash = [&text] (size_t start)
+    {
+        return fibb::Rolling_Hash<char>(fibb::Array_Wrapper<const char, fibb::dynamic_extent>(text.data() + start, 11)).value();
+    };
+    FIBB_CHECK(window_hash(0) == window_hash(24) && window_hash(0) != window_hash(1));
+}
+
+int main()
+{
+    test_dynamic_construction();
+    test_dynamic_assignment_copies();
+    test_dynamic_move_assignment();
+    test_dynamic_size_mismatch();
+    test_fixed_subviews();
+    test_runtime_subviews();
+    test_subview_out_of_range();
+    test_unrolled_paths();
+    test_bytewise_hash();
+    test_elementwise_hash();
+    test_unordered_set_of_wrappers();
+    test_rolling_hash();
+}
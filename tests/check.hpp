@@ -0,0 +1,30 @@
+#ifndef FIBB_TESTS_CHECK
+#define FIBB_TESTS_CHECK
+
+#include <cstdio>
+#include <cstdlib>
+
+// Each test is a standalone program built from this directory with the repository root on the
+// include path, e.g. c++ -std=c++17 -I.. algorithm_array_wrapper_test.cpp, and fails by exiting
+// non-zero. Unlike assert() the checks stay in release builds.
+#define FIBB_CHECK(cond) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (false)
+
+// checks that evaluating expr throws an exception of the given type
+#define FIBB_CHECK_THROWS(expr, exception) \
+    do \
+    { \
+        bool threw = false; \
+        try { static_cast<void>(expr); } \
+        catch (const exception&) { threw = true; } \
+        FIBB_CHECK(threw && #expr " throws " #exception); \
+    } while (false)
+
+#endif
@@ -0,0 +1,42 @@
+// also build with -mfma, which takes the std::fma path of fibb::fma
+#include "expression_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <type_traits>
+
+// fma returns the common type of its operands whichever way it is computed
+static void test_fma_type()
+{
+    constexpr fibb::detail::Fma fma{};
+    static_assert(std::is_same_v<decltype(fma(1.0f, 2, 3.0f)), float>);
+    static_assert(std::is_same_v<decltype(fma(1.0f, 2.0f, 3.0f)), float>);
+    static_assert(std::is_same_v<decltype(fma(1.0f, 2.0, 3)), double>);
+    static_assert(std::is_same_v<decltype(fma(1, 2, 3)), int>);
+    FIBB_CHECK(fma(1.5f, 2, 0.25f) == 3.25f);
+}
+
+static void test_fma_expressions()
+{
+    float a[4] = {1, 2, 3, 4};
+    float b[4] = {1, 1, 1, 1};
+    float out[4];
+    fibb::Array_Wrapper<float, 4> x(a);
+    fibb::Array_Wrapper<float, 4> y(b);
+    fibb::Array_Wrapper<float, 4> z(out);
+
+    z = fibb::fma(x, 2, y);
+    FIBB_CHECK(out[0] == 3.0f && out[3] == 9.0f);
+    z = fibb::fma(x, x, -y) + fibb::fma(2.0f, y, 1);
+    FIBB_CHECK(out[0] == 3.0f && out[3] == 18.0f);
+
+    int n[3] = {1, 2, 3};
+    fibb::Array_Wrapper<int, 3> w(n);
+    w = fibb::fma(w, 3, 1);
+    FIBB_CHECK(n[0] == 4 && n[2] == 10);
+}
+
+int main()
+{
+    test_fma_type();
+    test_fma_expressions();
+}
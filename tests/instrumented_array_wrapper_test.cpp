@@ -0,0 +1,108 @@
+// every operation is timed once a hook is installed
+#define FIBB_ARRAY_WRAPPER_INSTRUMENT 1
+#define FIBB_ARRAY_WRAPPER_TRACE_SAMPLE_RATE 1
+
+#include "array_wrapper.hpp"
+#include "check.hpp"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // the change in an operation's totals since it was constructed
+    struct Count_Delta
+    {
+        explicit Count_Delta(fibb::Wrapper_Operation operation_)
+            : operation(operation_), before(fibb::operation_count(operation_))
+        {}
+
+        bool is(std::uint64_t calls, std::uint64_t bytes) const
+        {
+            const fibb::Operation_Count now = fibb::operation_count(operation);
+            return now.calls - before.calls == calls && now.bytes - before.bytes == bytes;
+        }
+
+        fibb::Wrapper_Operation operation;
+        fibb::Operation_Count before;
+    };
+
+    std::vector<fibb::Trace_Event> events;
+
+    void record_event(const fibb::Trace_Event& event) { events.push_back(event); }
+}
+
+static void test_operation_counts()
+{
+    int a_values[4] = {1, 2, 3, 4};
+    int b_values[4] = {5, 6, 7, 8};
+    fibb::Array_Wrapper<int, 4> a(a_values);
+    fibb::Array_Wrapper<int, 4> b(b_values);
+    std::vector<double> storage(10);
+    fibb::Array_Wrapper<double, fibb::dynamic_extent> dyn(storage.data(), storage.size());
+
+    const Count_Delta assign(fibb::Wrapper_Operation::Assign);
+    a = b;
+    FIBB_CHECK(assign.is(1, 16) && a_values[0] == 5);
+
+    const Count_Delta fill(fibb::Wrapper_Operation::Fill);
+    a.fill(0);
+    dyn.fill(1.5);
+    FIBB_CHECK(fill.is(2, 16 + 80));
+
+    const Count_Delta swap(fibb::Wrapper_Operation::Swap);
+    a.swap(b);
+    FIBB_CHECK(swap.is(1, 16) && b_values[0] == 0);
+
+    const Count_Delta compare(fibb::Wrapper_Operation::Compare);
+    FIBB_CHECK(a != b && !(a < b));
+    FIBB_CHECK(compare.is(2, 32));
+
+    const Count_Delta at_failure(fibb::Wrapper_Operation::At_Failure);
+    FIBB_CHECK(a.at(3) == 8 && at_failure.is(0, 0));
+    FIBB_CHECK_THROWS(a.at(4), std::out_of_range);
+    FIBB_CHECK_THROWS(dyn.at(10), std::out_of_range);
+    FIBB_CHECK(at_failure.is(2, 0));
+}
+
+static void test_thread_counts()
+{
+    // a thread's counts reach the totals when it exits, even before a flush is due
+    const Count_Delta fill(fibb::Wrapper_Operation::Fill);
+    std::thread worker([]
+    {
+        char values[3];
+        fibb::Array_Wrapper<char, 3> w(values);
+        for (int i = 0; i < 5; ++i) { w.fill('x'); }
+    });
+    worker.join();
+    FIBB_CHECK(fill.is(5, 15));
+}
+
+static void test_trace_hook()
+{
+    int values[4] = {1, 2, 3, 4};
+    fibb::Array_Wrapper<int, 4> w(values);
+
+    FIBB_CHECK(fibb::set_trace_hook(record_event) == nullptr);
+    w.fill(7);
+    FIBB_CHECK_THROWS(w.at(9), std::out_of_range);
+    FIBB_CHECK(events.size() == 2);
+    FIBB_CHECK(events[0].operation == fibb::Wrapper_Operation::Fill && events[0].data == values && events[0].bytes == 16);
+    // a failed at() is reported before the exception leaves it
+    FIBB_CHECK(events[1].operation == fibb::Wrapper_Operation::At_Failure && events[1].data == values && events[1].bytes == 0);
+    FIBB_CHECK(events[0].start != 0 && events[1].start >= events[0].start + events[0].duration);
+
+    // without a hook nothing is timed
+    FIBB_CHECK(fibb::set_trace_hook(nullptr) == record_event);
+    w.fill(8);
+    FIBB_CHECK(events.size() == 2);
+}
+
+int main()
+{
+    test_operation_counts();
+    test_thread_counts();
+    test_trace_hook();
+}
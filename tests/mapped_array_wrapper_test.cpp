@@ -0,0 +1,140 @@
+#include "mapped_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+    // a file in the temporary directory which is removed again at the end of the scope
+    class Temp_File
+    {
+        public:
+            explicit Temp_File(const std::vector<unsigned char>& contents_)
+            {
+                const char* dir = std::getenv("TMPDIR");
+                m_path = std::string(dir != nullptr ? dir : "/tmp") + "/fibb_mapped_XXXXXX";
+                const int fd = ::mkstemp(&m_path[0]);
+                FIBB_CHECK(fd >= 0);
+                FIBB_CHECK(contents_.empty() || ::write(fd, contents_.data(), contents_.size()) == static_cast<ssize_t>(contents_.size()));
+                ::close(fd);
+            }
+
+            Temp_File(const Temp_File&) = delete;
+            Temp_File& operator=(const Temp_File&) = delete;
+
+            ~Temp_File() { std::remove(m_path.c_str()); }
+
+            const std::string& path() const noexcept { return m_path; }
+
+            std::vector<unsigned char> contents() const
+            {
+                std::vector<unsigned char> bytes;
+                if (std::FILE* file = std::fopen(m_path.c_str(), "rb"))
+                {
+                    for (int c; (c = std::fgetc(file)) != EOF;) { bytes.push_back(static_cast<unsigned char>(c)); }
+                    std::fclose(file);
+                }
+                return bytes;
+            }
+
+        private:
+            std::string m_path;
+    };
+
+    template <typename T>
+    std::vector<unsigned char> bytes_of(const std::vector<T>& values)
+    {
+        std::vector<unsigned char> bytes(values.size() * sizeof(T));
+        if (!bytes.empty()) { std::memcpy(bytes.data(), values.data(), bytes.size()); }
+        return bytes;
+    }
+}
+
+static void test_round_trip()
+{
+    const std::vector<float> table = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f};
+    const Temp_File temp(bytes_of(table));
+
+    fibb::Mapped_File file(temp.path(), fibb::Map_Mode::Read_Only, fibb::Map_Advice::Will_Need | fibb::Map_Advice::Sequential);
+    FIBB_CHECK(file.size() == table.size() * sizeof(float) && !file.empty() && file.mode() == fibb::Map_Mode::Read_Only);
+
+    const fibb::Array_Wrapper<const float, 6> fixed = file.view<const float, 6>();
+    FIBB_CHECK(fixed[0] == 0.5f && fixed[5] == 5.5f);
+
+    const auto tail = file.view<const float>(2 * sizeof(float));
+    FIBB_CHECK(tail.size() == 4 && tail.front() == 2.5f && tail.back() == 5.5f);
+    FIBB_CHECK(file.view<const float>(sizeof(float), 2).size() == 2 && file.view<const float>(file.size()).empty());
+
+    // a range starting part way into the file, and the mapping moves with its owner
+    fibb::Mapped_File part(temp.path(), fibb::Map_Mode::Read_Only, fibb::Map_Advice::Normal, 3 * sizeof(float), 2 * sizeof(float));
+    fibb::Mapped_File moved(std::move(part));
+    FIBB_CHECK(part.empty() && moved.size() == 2 * sizeof(float));
+    const auto middle = moved.view<const float, 2>();
+    FIBB_CHECK(middle[0] == 3.5f && middle[1] == 4.5f);
+}
+
+static void test_writable_mappings()
+{
+    const std::vector<int> values = {1, 2, 3, 4};
+    const Temp_File temp(bytes_of(values));
+
+    {
+        fibb::Mapped_File file(temp.path(), fibb::Map_Mode::Copy_On_Write);
+        fibb::Array_Wrapper<int, 4> view = file.view<int, 4>();
+        view.fill(9);
+        FIBB_CHECK(view[3] == 9);
+    }
+    FIBB_CHECK(temp.contents() == bytes_of(values));
+
+    {
+        fibb::Mapped_File file(temp.path(), fibb::Map_Mode::Read_Write);
+        auto view = file.view<int>();
+        view[1] = 20;
+        file.flush();
+    }
+    FIBB_CHECK(temp.contents() == bytes_of(std::vector<int>{1, 20, 3, 4}));
+}
+
+// the file decides what fits, so these are rejected whatever the check policy
+static void test_rejected_views()
+{
+    const std::vector<std::uint32_t> values = {1, 2, 3};
+    const Temp_File temp(bytes_of(values));
+    fibb::Mapped_File file(temp.path());
+
+    FIBB_CHECK_THROWS((file.view<const std::uint32_t, 4>()), std::length_error);
+    FIBB_CHECK_THROWS((file.view<const std::uint32_t, 3>(4)), std::length_error);
+    FIBB_CHECK_THROWS(file.view<const std::uint32_t>(4, 3), std::length_error);
+    FIBB_CHECK_THROWS(file.view<const std::uint32_t>(13), std::out_of_range);
+    FIBB_CHECK_THROWS((file.view<const std::uint32_t, 1>(2)), std::invalid_argument);
+    FIBB_CHECK_THROWS((file.view<std::uint32_t, 1>()), std::invalid_argument);
+
+    // a file truncated short of the table it should hold
+    const Temp_File truncated(std::vector<unsigned char>(7, 0));
+    fibb::Mapped_File short_file(truncated.path());
+    FIBB_CHECK_THROWS((short_file.view<const double, 1>()), std::length_error);
+    FIBB_CHECK(short_file.view<const double>().empty());
+
+    FIBB_CHECK_THROWS(fibb::Mapped_File(temp.path(), fibb::Map_Mode::Read_Only, fibb::Map_Advice::Normal, 13), std::out_of_range);
+    FIBB_CHECK_THROWS(fibb::Mapped_File(temp.path(), fibb::Map_Mode::Read_Only, fibb::Map_Advice::Normal, 4, 9), std::length_error);
+    FIBB_CHECK_THROWS(fibb::Mapped_File(temp.path() + ".missing"), std::system_error);
+
+    // an empty file maps to nothing
+    const Temp_File empty(std::vector<unsigned char>{});
+    fibb::Mapped_File empty_file(empty.path());
+    FIBB_CHECK(empty_file.empty() && empty_file.view<const int>().empty());
+}
+
+int main()
+{
+    test_round_trip();
+    test_writable_mappings();
+    test_rejected_views();
+}
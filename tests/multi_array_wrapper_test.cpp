@@ -0,0 +1,40 @@
+#include "multi_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <string>
+
+// copy assignment copies non-trivial elements and leaves the source intact
+static void test_copy_assignment()
+{
+    std::string a[2][3] = {{"a", "b", "c"}, {"d", "e", "f"}};
+    std::string b[2][3];
+    fibb::Multi_Array_Wrapper<std::string, 2, 3> src(a);
+    fibb::Multi_Array_Wrapper<std::string, 2, 3> dest(b);
+
+    dest = src;
+    FIBB_CHECK(b[0][0] == "a" && b[1][2] == "f");
+    FIBB_CHECK(a[0][0] == "a" && a[1][2] == "f");
+    FIBB_CHECK(dest == src);
+
+    dest = dest;
+    FIBB_CHECK(b[1][1] == "e");
+}
+
+static void test_column_major_copy_assignment()
+{
+    std::string a[6] = {"a", "b", "c", "d", "e", "f"};
+    std::string b[6];
+    std::string* pa = a;
+    std::string* pb = b;
+    fibb::Basic_Multi_Array_Wrapper<std::string, fibb::Layout_Column_Major, 2, 3> src(pa);
+    fibb::Basic_Multi_Array_Wrapper<std::string, fibb::Layout_Column_Major, 2, 3> dest(pb);
+
+    dest = src;
+    for (int i = 0; i < 6; ++i) { FIBB_CHECK(b[i] == a[i] && !a[i].empty()); }
+}
+
+int main()
+{
+    test_copy_assignment();
+    test_column_major_copy_assignment();
+}
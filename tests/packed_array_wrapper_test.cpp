@@ -0,0 +1,74 @@
+#include "packed_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// buffers are heap allocated with exactly the words the elements need, so that a sanitizer
+// catches any access past the last word
+
+template <size_t Bits>
+static void test_round_trip(size_t n)
+{
+    using Wrapper = fibb::Packed_Array_Wrapper<Bits>;
+    const size_t words = Wrapper::words_for(n);
+    std::unique_ptr<std::uint64_t[]> a(new std::uint64_t[words]());
+    std::unique_ptr<std::uint64_t[]> b(new std::uint64_t[words]());
+    Wrapper x(a.get(), n);
+    Wrapper y(b.get(), n);
+
+    std::vector<std::uint64_t> values(n);
+    for (size_t i = 0; i < n; ++i) { values[i] = (i * 0x9E3779B97F4A7C15u) & fibb::detail::low_bits(Bits); }
+    x.pack(fibb::Array_Wrapper<std::uint64_t, fibb::dynamic_extent>(values.data(), n));
+
+    std::vector<std::uint64_t> unpacked(n);
+    x.unpack(fibb::Array_Wrapper<std::uint64_t, fibb::dynamic_extent>(unpacked.data(), n));
+    FIBB_CHECK(unpacked == values);
+
+    y = x;
+    FIBB_CHECK(y == x);
+    for (size_t i = 0; i < n; ++i) { FIBB_CHECK(y[i] == values[i]); }
+
+    size_t expected_count = 0;
+    for (size_t i = 0; i < n; ++i) { expected_count += values[i] == values[0]; }
+    FIBB_CHECK(n == 0 || x.count(static_cast<typename Wrapper::value_type>(values[0])) == expected_count);
+
+    y.fill(1);
+    FIBB_CHECK(y.count(1) == n && y.count() == n);
+    x.swap(y);
+    FIBB_CHECK(x.count(1) == n);
+    for (size_t i = 0; i < n; ++i) { FIBB_CHECK(y[i] == values[i]); }
+}
+
+// a fixed size whose elements fill their words exactly
+static void test_whole_words()
+{
+    std::unique_ptr<std::uint64_t[]> a(new std::uint64_t[2]());
+    std::unique_ptr<std::uint64_t[]> b(new std::uint64_t[2]());
+    std::uint64_t* pa = a.get();
+    std::uint64_t* pb = b.get();
+    fibb::Bit_Array_Wrapper<128> x(pa);
+    fibb::Bit_Array_Wrapper<128> y(pb);
+
+    x[0] = 1;
+    x[127] = 1;
+    y = x;
+    FIBB_CHECK(y[0] == 1 && y[127] == 1 && y.count() == 2);
+    y.fill(1);
+    x.swap(y);
+    FIBB_CHECK(x.count() == 128 && y.count() == 2);
+}
+
+int main()
+{
+    for (size_t n : {0, 1, 63, 64, 65, 128})
+    {
+        test_round_trip<1>(n);
+        test_round_trip<8>(n);
+        test_round_trip<12>(n);
+        test_round_trip<64>(n);
+    }
+    test_round_trip<12>(16); // 192 bits, three whole words
+    test_whole_words();
+}
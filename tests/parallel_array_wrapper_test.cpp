@@ -0,0 +1,41 @@
+// <execution> may need -pthread and -ltbb with libstdc++
+#include "parallel_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+// non-trivial elements take the sequential fallback, which must copy and leave the source intact
+static void test_assign_copies()
+{
+    std::vector<std::string> a = {"a", "b", "c", "d"};
+    std::vector<std::string> b(4);
+    fibb::Thread_Executor executor(1);
+
+    fibb::assign(executor, fibb::Array_Wrapper<std::string, fibb::dynamic_extent>(b.data(), 4),
+        fibb::Array_Wrapper<std::string, fibb::dynamic_extent>(a.data(), 4));
+    FIBB_CHECK(a == b && a[3] == "d");
+
+    const std::string c[4] = {"w", "x", "y", "z"};
+    fibb::assign(executor, fibb::Array_Wrapper<std::string, fibb::dynamic_extent>(b.data(), 4),
+        fibb::Array_Wrapper<const std::string, 4>(c));
+    FIBB_CHECK(b[0] == "w" && b[3] == "z" && c[0] == "w");
+}
+
+static void test_assign_parallel()
+{
+    std::vector<int> a(100000);
+    std::vector<int> b(a.size());
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = static_cast<int>(i); }
+    fibb::Thread_Executor executor(4);
+
+    fibb::assign(executor, fibb::Array_Wrapper<int, fibb::dynamic_extent>(b.data(), b.size()),
+        fibb::Array_Wrapper<const int, fibb::dynamic_extent>(a.data(), a.size()));
+    FIBB_CHECK(a == b);
+}
+
+int main()
+{
+    test_assign_copies();
+    test_assign_parallel();
+}
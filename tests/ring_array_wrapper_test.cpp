@@ -0,0 +1,192 @@
+#include "ring_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// pushes and pops in uneven steps so the indices wrap around the array, and past twice its size,
+// many times over
+template <typename Ring>
+static void check_wraparound(Ring& ring)
+{
+    const size_t capacity = ring.capacity();
+    int next_in = 0, next_out = 0;
+    for (int round = 0; round < 50; ++round)
+    {
+        const size_t pushes = static_cast<size_t>(round) % capacity + 1;
+        for (size_t i = 0; i < pushes; ++i)
+        {
+            if (ring.full()) { FIBB_CHECK(!ring.push(-1)); break; }
+            FIBB_CHECK(ring.push(next_in++));
+        }
+        FIBB_CHECK(ring.size() == static_cast<size_t>(next_in - next_out) && ring.size() <= capacity);
+
+        const size_t pops = static_cast<size_t>(round * 7) % capacity;
+        for (size_t i = 0; i < pops && !ring.empty(); ++i)
+        {
+            int val = -1;
+            FIBB_CHECK(ring.pop(val) && val == next_out++);
+        }
+    }
+
+    int val;
+    while (ring.pop(val)) { FIBB_CHECK(val == next_out++); }
+    FIBB_CHECK(ring.empty() && next_out == next_in && !ring.pop(val));
+}
+
+static void test_wraparound()
+{
+    int masked[4];
+    fibb::Ring_Wrapper ring(masked);
+    static_assert(std::is_same_v<decltype(ring), fibb::Ring_Wrapper<int, 4>>);
+    check_wraparound(ring);
+
+    int odd[5];
+    fibb::Ring_Wrapper<int, 5> odd_ring(odd);
+    check_wraparound(odd_ring);
+
+    std::vector<int> storage(3);
+    fibb::Ring_Wrapper dynamic_ring(storage.data(), storage.size());
+    check_wraparound(dynamic_ring);
+
+    int single[1];
+    fibb::Ring_Wrapper<int, 1> single_ring(single);
+    check_wraparound(single_ring);
+
+    int concurrent[6];
+    fibb::SPSC_Ring_Wrapper<int, 6> concurrent_ring(concurrent);
+    check_wraparound(concurrent_ring);
+}
+
+static void test_segments()
+{
+    char storage[5];
+    fibb::Ring_Wrapper<char, 5> ring(storage);
+    const char hello[] = "hello";
+    FIBB_CHECK(ring.push(fibb::Array_Wrapper<const char, fibb::dynamic_extent>(hello, 3)) == 3);
+
+    char out[2];
+    FIBB_CHECK(ring.pop(fibb::Array_Wrapper<char, 2>(out)) == 2 && out[0] == 'h' && out[1] == 'e');
+
+    // the free slots now wrap around the end of the array
+    fibb::Ring_Segments<char> free = ring.write_segments();
+    FIBB_CHECK(free.size() == 4 && free.first.data() == storage + 3 && free.first.size() == 2);
+    FIBB_CHECK(free.second.data() == storage && free.second.size() == 2);
+    free.first[0] = 'a';
+    free.first[1] = 'b';
+    free.second[0] = 'c';
+    FIBB_CHECK(ring.size() == 1);
+    ring.commit_write(3);
+    FIBB_CHECK(ring.size() == 4);
+    FIBB_CHECK_THROWS(ring.commit_write(2), std::length_error);
+
+    const fibb::Ring_Segments<char> filled = ring.read_segments(3);
+    FIBB_CHECK(filled.size() == 3 && filled.first.size() == 3 && filled.first[0] == 'l' && filled.first[2] == 'b');
+    ring.commit_read(3);
+    const fibb::Ring_Segments<char> rest = ring.read_segments();
+    FIBB_CHECK(rest.size() == 1 && rest.first[0] == 'c' && rest.second.empty());
+    FIBB_CHECK_THROWS(ring.commit_read(2), std::length_error);
+
+    // pushing more than fits keeps the leading values
+    FIBB_CHECK(ring.push(fibb::Array_Wrapper<const char, fibb::dynamic_extent>(hello, 5)) == 4 && ring.full());
+    char all[5];
+    FIBB_CHECK(ring.pop(fibb::Array_Wrapper<char, 5>(all)) == 5 && all[0] == 'c' && all[1] == 'h' && all[4] == 'l');
+
+    ring.push('x');
+    ring.clear();
+    FIBB_CHECK(ring.empty() && ring.read_segments().empty());
+}
+
+static void test_values()
+{
+    std::string storage[3];
+    fibb::Ring_Wrapper<std::string, 3> ring(storage);
+    std::string long_string = "a long string which is not stored inline";
+    FIBB_CHECK(ring.push(long_string) && long_string == "a long string which is not stored inline");
+    FIBB_CHECK(ring.push(std::move(long_string)));
+
+    std::string out;
+    FIBB_CHECK(ring.pop(out) && out == "a long string which is not stored inline");
+    FIBB_CHECK(ring.pop(out) && out == "a long string which is not stored inline");
+}
+
+static void test_invalid_capacity()
+{
+    int a[1];
+    FIBB_CHECK_THROWS((fibb::Ring_Wrapper<int>(a, 0)), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::Ring_Wrapper<int>(fibb::Array_Wrapper<int, fibb::dynamic_extent>()), std::invalid_argument);
+}
+
+// one thread pushes a sequence, another pops it and checks that nothing is lost, repeated or
+// reordered, while a third samples size() which must stay within the capacity. A side which can't
+// make progress yields, so the test also finishes quickly on a single core.
+template <size_t N>
+static void check_spsc()
+{
+    constexpr std::uint64_t count = 100000;
+    std::uint64_t storage[N];
+    fibb::SPSC_Ring_Wrapper<std::uint64_t, N> ring(storage);
+    std::atomic<bool> done{false};
+    std::atomic<bool> size_in_range{true};
+
+    std::thread producer([&ring]
+    {
+        std::uint64_t batch[7];
+        for (std::uint64_t next = 0; next < count;)
+        {
+            size_t pushed = 0;
+            if (next % 3 == 0) { pushed = ring.push(next) ? 1 : 0; }
+            else
+            {
+                size_t n = 0;
+                for (; n < 7 && next + n < count; ++n) { batch[n] = next + n; }
+                pushed = ring.push(fibb::Array_Wrapper<const std::uint64_t, fibb::dynamic_extent>(batch, n));
+            }
+            if (pushed == 0) { std::this_thread::yield(); }
+            next += pushed;
+        }
+    });
+
+    std::thread observer([&ring, &done, &size_in_range]
+    {
+        while (!done.load(std::memory_order_relaxed))
+        {
+            if (ring.size() > ring.capacity()) { size_in_range.store(false); }
+            std::this_thread::yield();
+        }
+    });
+
+    std::uint64_t expected = 0;
+    bool in_order = true;
+    std::uint64_t batch[5];
+    while (expected < count)
+    {
+        const size_t n = ring.pop(fibb::Array_Wrapper<std::uint64_t, 5>(batch));
+        for (size_t i = 0; i < n; ++i) { in_order = in_order && batch[i] == expected++; }
+        if (n == 0) { std::this_thread::yield(); }
+    }
+
+    producer.join();
+    done.store(true);
+    observer.join();
+    FIBB_CHECK(in_order && ring.empty() && size_in_range.load());
+}
+
+static void test_spsc()
+{
+    check_spsc<8>();
+    check_spsc<7>();
+    check_spsc<1>();
+}
+
+int main()
+{
+    test_wraparound();
+    test_segments();
+    test_values();
+    test_invalid_capacity();
+    test_spsc();
+}
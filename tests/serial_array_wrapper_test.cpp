@@ -0,0 +1,217 @@
+#include "serial_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // a received message, aligned like the header asks for
+    struct Buffer
+    {
+        alignas(16) unsigned char bytes[256] = {};
+        size_t size = 0;
+
+        void write(const void* data_, size_t bytes_)
+        {
+            if (bytes_ > 0) { std::memcpy(bytes + size, data_, bytes_); }
+            size += bytes_;
+        }
+
+        fibb::Array_Wrapper<unsigned char, fibb::dynamic_extent> view() { return {bytes, size}; }
+        fibb::Array_Wrapper<const unsigned char, fibb::dynamic_extent> const_view() const { return {bytes, size}; }
+    };
+
+    template <typename T, size_t N>
+    void append(Buffer& buffer, const fibb::Array_Wrapper<T, N>& array_, fibb::Endian endian = fibb::Endian::Native)
+    {
+        const fibb::Array_Header header = fibb::make_header(array_, endian);
+        buffer.write(header.data(), header.size());
+        const auto payload = fibb::as_bytes(array_);
+        buffer.write(payload.data(), payload.size());
+    }
+
+    // the byte order reversed one byte at a time, to check the vectorized kernels against
+    template <typename T>
+    T reversed_bytes(T value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (size_t i = 0; i < sizeof(T) / 2; ++i) { std::swap(bytes[i], bytes[sizeof(T) - 1 - i]); }
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    constexpr fibb::Endian foreign_endian = fibb::Endian::Native == fibb::Endian::Little ? fibb::Endian::Big : fibb::Endian::Little;
+}
+
+static void test_byte_views()
+{
+    std::uint32_t values[3] = {1, 0x01020304, 0xFFFFFFFF};
+    const fibb::Array_Wrapper<std::uint32_t, 3> w(values);
+    const auto bytes = fibb::as_bytes(w);
+    static_assert(std::is_same_v<decltype(bytes), const fibb::Array_Wrapper<const unsigned char, 12>>);
+    FIBB_CHECK(bytes.data() == reinterpret_cast<const unsigned char*>(values));
+
+    const auto back = fibb::from_bytes<const std::uint32_t, 3>(bytes);
+    FIBB_CHECK(back.data() == values && back[1] == 0x01020304);
+    const auto dyn = fibb::from_bytes<const std::uint32_t>(bytes);
+    FIBB_CHECK(dyn.size() == 3 && dyn[2] == 0xFFFFFFFF);
+
+    auto writable = fibb::as_writable_bytes(fibb::Array_Wrapper<std::uint32_t, 3>(values));
+    writable[0] = 7;
+    FIBB_CHECK(values[0] == (fibb::Endian::Native == fibb::Endian::Little ? 7u : 0x07000000u));
+
+    FIBB_CHECK_THROWS(fibb::from_bytes<const std::uint32_t>(bytes.first(10)), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::from_bytes<const std::uint32_t>(bytes.subspan(1, 8)), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::from_bytes<const std::uint32_t, 2>(bytes)), std::invalid_argument);
+}
+
+template <typename T>
+static void check_byteswap()
+{
+    // long enough for the vector loops and every length of tail after them
+    for (size_t n = 0; n <= 70; ++n)
+    {
+        std::vector<T> values(n), expected(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::uint64_t pattern = 0x0102030405060708ull * (i + 1) + i;
+            std::memcpy(&values[i], &pattern, sizeof(T));
+            expected[i] = reversed_bytes(values[i]);
+        }
+        const std::vector<T> original = values;
+
+        fibb::byteswap(fibb::Array_Wrapper<T, fibb::dynamic_extent>(values.data(), n));
+        FIBB_CHECK(n == 0 || std::memcmp(values.data(), expected.data(), n * sizeof(T)) == 0);
+        fibb::convert_endian(fibb::Array_Wrapper<T, fibb::dynamic_extent>(values.data(), n), foreign_endian);
+        FIBB_CHECK(n == 0 || std::memcmp(values.data(), original.data(), n * sizeof(T)) == 0);
+        fibb::convert_endian(fibb::Array_Wrapper<T, fibb::dynamic_extent>(values.data(), n), fibb::Endian::Native);
+        FIBB_CHECK(n == 0 || std::memcmp(values.data(), original.data(), n * sizeof(T)) == 0);
+    }
+}
+
+static void test_byteswap()
+{
+    check_byteswap<std::uint16_t>();
+    check_byteswap<std::int32_t>();
+    check_byteswap<std::uint64_t>();
+    check_byteswap<float>();
+    check_byteswap<double>();
+
+    std::uint8_t bytes[3] = {1, 2, 3};
+    fibb::byteswap(fibb::Array_Wrapper<std::uint8_t, 3>(bytes));
+    FIBB_CHECK(bytes[0] == 1 && bytes[2] == 3);
+}
+
+static void test_header()
+{
+    const fibb::Array_Header header(8, 0x0102030405060708ull, fibb::Endian::Big);
+    FIBB_CHECK(header.size() == 16 && std::memcmp(header.data(), "FIBB", 4) == 0 && header.version() == 1);
+    FIBB_CHECK(header.payload_endian() == fibb::Endian::Big && header.element_size() == 8 && header.count() == 0x0102030405060708ull);
+    // the fields are little endian whatever the host
+    FIBB_CHECK(header.data()[5] == 1 && header.data()[6] == 8 && header.data()[7] == 0 && header.data()[8] == 8 && header.data()[15] == 1);
+
+    const fibb::Array_Wrapper<const unsigned char, fibb::dynamic_extent> bytes(header.data(), header.size());
+    const fibb::Array_Header parsed = fibb::Array_Header::parse(bytes);
+    FIBB_CHECK(parsed.count() == header.count() && parsed.element_size() == 8 && parsed.payload_endian() == fibb::Endian::Big);
+
+    FIBB_CHECK_THROWS(fibb::Array_Header(0x10000, 1), std::invalid_argument);
+}
+
+static void test_round_trip()
+{
+    double values[5] = {0.5, -1, 1e300, 0, 3.25};
+    Buffer buffer;
+    append(buffer, fibb::Array_Wrapper<const double, 5>(values));
+    FIBB_CHECK(buffer.size == 16 + sizeof(values));
+
+    const auto fixed = fibb::deserialize<const double, 5>(buffer.const_view());
+    FIBB_CHECK(fixed.data() == reinterpret_cast<const double*>(buffer.bytes + 16) && fixed[2] == 1e300);
+    const auto dyn = fibb::deserialize<const double>(buffer.const_view());
+    FIBB_CHECK(dyn.size() == 5 && dyn[4] == 3.25);
+
+    // trailing bytes after the payload are left to the caller
+    buffer.size += 3;
+    FIBB_CHECK(fibb::deserialize<const double>(buffer.const_view()).size() == 5);
+
+    // a payload in the other byte order is converted in place
+    std::uint32_t words[4] = {1, 2, 0xA0B0C0D0, 4};
+    std::uint32_t swapped[4];
+    for (size_t i = 0; i < 4; ++i) { swapped[i] = reversed_bytes(words[i]); }
+    Buffer foreign;
+    const fibb::Array_Header header = fibb::make_header(fibb::Array_Wrapper<std::uint32_t, 4>(words), foreign_endian);
+    foreign.write(header.data(), header.size());
+    foreign.write(swapped, sizeof(swapped));
+    const auto native = fibb::deserialize<std::uint32_t, 4>(foreign.view());
+    FIBB_CHECK(native[0] == 1 && native[2] == 0xA0B0C0D0 && native[3] == 4);
+
+    // empty arrays round trip too
+    Buffer empty;
+    append(empty, fibb::Array_Wrapper<const int, fibb::dynamic_extent>());
+    FIBB_CHECK(fibb::deserialize<const int>(empty.const_view()).empty());
+}
+
+static void test_rejected_buffers()
+{
+    int values[4] = {1, 2, 3, 4};
+    Buffer good;
+    append(good, fibb::Array_Wrapper<const int, 4>(values));
+    const auto bytes = good.const_view();
+
+    // truncated in the header or the payload
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(bytes.first(15)), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(bytes.first(bytes.size() - 1)), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::deserialize<const int, 3>(bytes)), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::deserialize<const std::int64_t>(bytes), std::invalid_argument);
+
+    // corrupt fields
+    const auto corrupt = [&good] (size_t pos, unsigned char value)
+    {
+        Buffer copy = good;
+        copy.bytes[pos] = value;
+        return copy;
+    };
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(corrupt(0, 'X').const_view()), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(corrupt(4, 2).const_view()), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(corrupt(6, 2).const_view()), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(corrupt(15, 0x80).const_view()), std::invalid_argument);
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(corrupt(8, 5).const_view()), std::invalid_argument);
+
+    // a foreign payload can't be swapped in a read only buffer
+    Buffer foreign;
+    append(foreign, fibb::Array_Wrapper<const int, 4>(values), foreign_endian);
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(foreign.const_view()), std::invalid_argument);
+
+    // a misaligned payload
+    Buffer shifted;
+    shifted.size = 1;
+    append(shifted, fibb::Array_Wrapper<const int, 4>(values));
+    FIBB_CHECK_THROWS(fibb::deserialize<const int>(shifted.const_view().subspan(1)), std::invalid_argument);
+}
+
+#if defined(FIBB_ARRAY_WRAPPER_IOVEC)
+static void test_iovecs()
+{
+    short values[3] = {1, 2, 3};
+    const fibb::Array_Wrapper<short, 3> w(values);
+    const fibb::Array_Header header = fibb::make_header(w);
+    const auto parts = fibb::to_iovecs(header, w);
+    FIBB_CHECK(parts[0].iov_base == header.data() && parts[0].iov_len == 16);
+    FIBB_CHECK(parts[1].iov_base == values && parts[1].iov_len == sizeof(values));
+}
+#endif
+
+int main()
+{
+    test_byte_views();
+    test_byteswap();
+    test_header();
+    test_round_trip();
+    test_rejected_buffers();
+#if defined(FIBB_ARRAY_WRAPPER_IOVEC)
+    test_iovecs();
+#endif
+}
@@ -0,0 +1,127 @@
+#include "strided_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    struct Particle
+    {
+        float x;
+        float mass;
+        char tag;
+    };
+}
+
+static void test_member_view()
+{
+    Particle particles[4] = {{0, 3, 'a'}, {1, 1, 'b'}, {2, 4, 'c'}, {3, 2, 'd'}};
+    fibb::Strided_Array_Wrapper masses(particles, &Particle::mass);
+    static_assert(std::is_same_v<decltype(masses), fibb::Strided_Array_Wrapper<float, 4, sizeof(Particle)>>);
+    FIBB_CHECK(masses.size() == 4 && masses.stride() == sizeof(Particle));
+    FIBB_CHECK(masses.data() == &particles[0].mass && masses[2] == 4 && masses.back() == 2);
+
+    // sorting the field leaves the other fields in place
+    std::sort(masses.begin(), masses.end());
+    FIBB_CHECK(particles[0].mass == 1 && particles[1].mass == 2 && particles[2].mass == 3 && particles[3].mass == 4);
+    FIBB_CHECK(particles[0].x == 0 && particles[3].tag == 'd');
+}
+
+static void test_iterator_arithmetic()
+{
+    int samples[12];
+    for (int i = 0; i < 12; ++i) { samples[i] = i; }
+    fibb::Strided_Array_Wrapper<int, 4> every_third(samples, fibb::Element_Stride{3});
+
+    auto it = every_third.begin();
+    FIBB_CHECK(*it == 0 && it[2] == 6 && *(it + 3) == 9);
+    FIBB_CHECK(every_third.end() - every_third.begin() == 4);
+    FIBB_CHECK(std::distance(every_third.begin(), every_third.end()) == 4);
+
+    auto third = it + 2;
+    FIBB_CHECK(third - it == 2 && it - third == -2);
+    FIBB_CHECK(it < third && third > it && it <= it && third >= it && it != third);
+    FIBB_CHECK(*--third == 3 && *third++ == 3 && *third == 6);
+    third -= 2;
+    FIBB_CHECK(third == it);
+    FIBB_CHECK(2 + it == it + 2);
+
+    fibb::Strided_Array_Wrapper<int, 4>::const_iterator const_it = it;
+    FIBB_CHECK(*const_it == 0);
+
+    int reversed[4];
+    std::copy(every_third.rbegin(), every_third.rend(), reversed);
+    FIBB_CHECK(reversed[0] == 9 && reversed[3] == 0);
+}
+
+static void test_gather_scatter()
+{
+    short stereo[8] = {1, -1, 2, -2, 3, -3, 4, -4};
+    fibb::Strided_Array_Wrapper<short, 4> left(stereo, fibb::Element_Stride{2});
+    fibb::Strided_Array_Wrapper<short, 4> right(stereo + 1, fibb::Byte_Stride{2 * sizeof(short)});
+    fibb::Element_Strided_Array_Wrapper<short, 4, 2> fixed_left(stereo);
+
+    short scratch[4];
+    left.gather(fibb::Array_Wrapper<short, 4>(scratch));
+    FIBB_CHECK(scratch[0] == 1 && scratch[3] == 4);
+    FIBB_CHECK(std::equal(fixed_left.begin(), fixed_left.end(), scratch));
+
+    for (short& s : scratch) { s = static_cast<short>(s * 10); }
+    right.scatter(fibb::Array_Wrapper<short, 4>(scratch));
+    FIBB_CHECK(stereo[1] == 10 && stereo[7] == 40 && stereo[0] == 1);
+
+    // dynamic sizes must match
+    short out[3];
+    fibb::Strided_Array_Wrapper<short, fibb::dynamic_extent> dyn(stereo, 4, fibb::Element_Stride{2});
+    FIBB_CHECK_THROWS(dyn.gather(fibb::Array_Wrapper<short, fibb::dynamic_extent>(out, 3)), std::length_error);
+}
+
+static void test_fill_swap_assign()
+{
+    std::string interleaved[6] = {"a", "1", "b", "2", "c", "3"};
+    fibb::Strided_Array_Wrapper<std::string, 3> letters(interleaved, fibb::Element_Stride{2});
+    fibb::Strided_Array_Wrapper<std::string, 3> digits(interleaved + 1, fibb::Element_Stride{2});
+
+    letters.swap(digits);
+    FIBB_CHECK(interleaved[0] == "1" && interleaved[1] == "a" && interleaved[5] == "c");
+
+    letters = digits;
+    FIBB_CHECK(interleaved[0] == "a" && interleaved[4] == "c" && interleaved[5] == "c");
+    FIBB_CHECK(letters == digits && !(letters < digits) && letters <= digits);
+
+    digits.fill("z");
+    FIBB_CHECK(interleaved[1] == "z" && interleaved[3] == "z" && interleaved[0] == "a");
+    FIBB_CHECK(letters < digits && digits > letters);
+
+    fibb::Strided_Array_Wrapper<std::string, fibb::dynamic_extent> two(interleaved, 2, fibb::Element_Stride{2});
+    fibb::Strided_Array_Wrapper<std::string, fibb::dynamic_extent> three(interleaved + 1, 3, fibb::Element_Stride{2});
+    FIBB_CHECK_THROWS(two = three, std::length_error);
+    FIBB_CHECK_THROWS(two.swap(three), std::length_error);
+    FIBB_CHECK_THROWS(two.at(2), std::out_of_range);
+}
+
+static void test_invalid_strides()
+{
+    int a[8] = {};
+    FIBB_CHECK_THROWS((fibb::Strided_Array_Wrapper<int, 4>(a, fibb::Element_Stride{0})), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::Strided_Array_Wrapper<int, 4>(a, fibb::Byte_Stride{0})), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::Strided_Array_Wrapper<int, fibb::dynamic_extent>(a, 4, fibb::Element_Stride{0})), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::Strided_Array_Wrapper<int, fibb::dynamic_extent>(a, 4, fibb::Byte_Stride{0})), std::invalid_argument);
+    FIBB_CHECK_THROWS((fibb::Strided_Array_Wrapper<int, 4>(a, fibb::Byte_Stride{6})), std::invalid_argument);
+
+    // an empty view may have any valid stride
+    fibb::Strided_Array_Wrapper<int, fibb::dynamic_extent> empty(a, 0, fibb::Element_Stride{2});
+    FIBB_CHECK(empty.begin() == empty.end() && empty.empty());
+}
+
+int main()
+{
+    test_member_view();
+    test_iterator_arithmetic();
+    test_gather_scatter();
+    test_fill_swap_assign();
+    test_invalid_strides();
+}
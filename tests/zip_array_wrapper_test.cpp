@@ -0,0 +1,129 @@
+#include "zip_array_wrapper.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+static void test_rows()
+{
+    int ids[3] = {1, 2, 3};
+    std::string names[3] = {"one", "two", "three"};
+    fibb::Zip_Array_Wrapper zip(ids, names);
+    static_assert(std::is_same_v<decltype(zip), fibb::Zip_Array_Wrapper<3, int, std::string>>);
+    FIBB_CHECK(zip.size() == 3 && !zip.empty() && zip.end() - zip.begin() == 3);
+    FIBB_CHECK(zip.get<0>().data() == ids && zip.get<1>().data() == names);
+
+    // rows refer to the elements
+    auto row = zip[1];
+    FIBB_CHECK(fibb::get<0>(row) == 2 && fibb::get<1>(row) == "two");
+    fibb::get<0>(row) = 20;
+    row.get<1>() = "twenty";
+    FIBB_CHECK(ids[1] == 20 && names[1] == "twenty");
+
+    zip.back() = std::make_tuple(30, std::string("thirty"));
+    FIBB_CHECK(ids[2] == 30 && names[2] == "thirty");
+
+    const std::tuple<int, std::string> copied = zip.front();
+    FIBB_CHECK(std::get<0>(copied) == 1 && std::get<1>(copied) == "one" && names[0] == "one");
+
+    const auto& read_only = zip;
+    FIBB_CHECK(std::get<1>(read_only[2].as_tuple()) == "thirty");
+    FIBB_CHECK_THROWS(zip.at(3), std::out_of_range);
+}
+
+static void test_reference_assignment_and_swap()
+{
+    int ids[2] = {1, 2};
+    std::string names[2] = {"a long string which is not stored inline", "b"};
+    fibb::Zip_Array_Wrapper zip(ids, names);
+
+    // swapping and assigning rows acts on the elements, not the proxies
+    swap(zip[0], zip[1]);
+    FIBB_CHECK(ids[0] == 2 && names[0] == "b" && ids[1] == 1 && names[1] == "a long string which is not stored inline");
+
+    zip[0] = zip[1];
+    FIBB_CHECK(ids[0] == 1 && names[0] == names[1]);
+
+    zip[1] = std::tuple<int, std::string>(5, "e");
+    std::tuple<int, std::string> moved = std::move(zip[0]);
+    FIBB_CHECK(std::get<1>(moved) == "a long string which is not stored inline" && ids[1] == 5 && names[1] == "e");
+    FIBB_CHECK(zip[0] < zip[1] && !(zip[1] < zip[0]) && zip[0] != zip[1]);
+}
+
+static void test_sort_by()
+{
+    int keys[5] = {4, 1, 3, 0, 2};
+    std::string values[5] = {"four", "one", "three", "zero", "two"};
+    double weights[5] = {0.4, 0.1, 0.3, 0.0, 0.2};
+    fibb::Zip_Array_Wrapper zip(keys, values, weights);
+
+    zip.sort_by<0>();
+    for (int i = 0; i < 5; ++i) { FIBB_CHECK(keys[i] == i && weights[i] == i / 10.0); }
+    FIBB_CHECK(values[0] == "zero" && values[2] == "two" && values[4] == "four");
+
+    zip.sort_by<1>(std::greater<>());
+    FIBB_CHECK(values[0] == "zero" && values[4] == "four" && keys[0] == 0 && keys[1] == 2 && keys[4] == 4);
+
+    // ties keep their order when sorting stably
+    int groups[4] = {1, 0, 1, 0};
+    int order[4] = {0, 1, 2, 3};
+    fibb::Zip_Array_Wrapper stable(groups, order);
+    stable.stable_sort_by<0>();
+    FIBB_CHECK(order[0] == 1 && order[1] == 3 && order[2] == 0 && order[3] == 2);
+
+    // the rows also sort with the standard algorithms, which compare proxies and copied rows alike
+    std::sort(stable.begin(), stable.end(), [] (const auto& a, const auto& b)
+    {
+        using std::get;
+        return get<1>(a) > get<1>(b);
+    });
+    FIBB_CHECK(order[0] == 3 && groups[0] == 0 && order[3] == 0 && groups[3] == 1);
+}
+
+static void test_fill_swap_assign()
+{
+    int a_ids[3] = {1, 2, 3};
+    std::string a_names[3] = {"a", "b", "c"};
+    int b_ids[3] = {4, 5, 6};
+    std::string b_names[3] = {"d", "e", "f"};
+    fibb::Zip_Array_Wrapper a(a_ids, a_names);
+    fibb::Zip_Array_Wrapper b(b_ids, b_names);
+
+    FIBB_CHECK(a != b && a < b && b > a && a <= b && b >= a);
+
+    a.swap(b);
+    FIBB_CHECK(a_ids[0] == 4 && a_names[2] == "f" && b_ids[0] == 1 && b_names[2] == "c");
+
+    a = b;
+    FIBB_CHECK(a_ids[1] == 2 && a_names[1] == "b" && b_names[1] == "b" && a == b);
+
+    b.fill(std::make_tuple(7, std::string("g")));
+    FIBB_CHECK(b_ids[0] == 7 && b_ids[2] == 7 && b_names[1] == "g" && a_ids[0] == 1);
+    FIBB_CHECK(a < b && !(b <= a));
+}
+
+static void test_dynamic_sizes()
+{
+    int ids[4] = {3, 2, 1, 0};
+    char tags[4] = {'d', 'c', 'b', 'a'};
+    using Zip = fibb::Zip_Array_Wrapper<fibb::dynamic_extent, int, char>;
+    Zip zip(fibb::Array_Wrapper<int, fibb::dynamic_extent>(ids, 4), fibb::Array_Wrapper<char, fibb::dynamic_extent>(tags, 4));
+    FIBB_CHECK(zip.size() == 4);
+    zip.sort_by<0>();
+    FIBB_CHECK(ids[0] == 0 && tags[0] == 'a' && ids[3] == 3 && tags[3] == 'd');
+
+    FIBB_CHECK_THROWS((Zip(fibb::Array_Wrapper<int, fibb::dynamic_extent>(ids, 4), fibb::Array_Wrapper<char, fibb::dynamic_extent>(tags, 3))),
+        std::length_error);
+}
+
+int main()
+{
+    test_rows();
+    test_reference_assignment_and_swap();
+    test_sort_by();
+    test_fill_swap_assign();
+    test_dynamic_sizes();
+}
@@ -0,0 +1,335 @@
+#ifndef FIBB_ZIP_ARRAY_WRAPPER
+#define FIBB_ZIP_ARRAY_WRAPPER
+
+#include "array_wrapper.hpp"
+
+#include <tuple>
+#include <utility>
+
+namespace fibb
+{
+    /* Proxy for one row of a Zip_Array_Wrapper, i.e. one element from each array. It behaves like
+       std::tuple<Ts&...> except that assignment and swap always act on the referenced elements, which
+       is what the standard algorithms expect when they permute a range through its iterators. */
+
+    template <typename... Ts>
+    class Zip_Reference
+    {
+        public:
+            using value_type = std::tuple<std::remove_cv_t<Ts>...>;
+
+            explicit Zip_Reference(Ts&... refs) noexcept : m_refs(refs...) {}
+
+            Zip_Reference(const Zip_Reference&) = default;
+
+            // a proxy is a temporary even when the row it refers to isn't being moved from, so assigning
+            // from another proxy copies; only a value_type rvalue, such as the temporary an algorithm
+            // holds a row in, is moved from
+            Zip_Reference& operator=(const Zip_Reference& other) { assign(other.m_refs); return *this; }
+            Zip_Reference& operator=(const value_type& val) { assign(val); return *this; }
+            Zip_Reference& operator=(value_type&& val) { assign_move(std::move(val)); return *this; }
+
+            // copies for the same reason, an rvalue proxy can't tell std::move(*it) apart from *it
+            operator value_type() const { return value_type(m_refs); }
+
+            template <size_t I>
+            auto& get() const noexcept { return std::get<I>(m_refs); }
+
+            std::tuple<const Ts&...> as_tuple() const noexcept { return m_refs; }
+
+            friend void swap(Zip_Reference a, Zip_Reference b) { a.swap_elements(b, std::index_sequence_for<Ts...>()); }
+
+            friend bool operator==(const Zip_Reference& a, const Zip_Reference& b) { return a.as_tuple() == b.as_tuple(); }
+            friend bool operator!=(const Zip_Reference& a, const Zip_Reference& b) { return !(a == b); }
+            friend bool operator<(const Zip_Reference& a, const Zip_Reference& b) { return a.as_tuple() < b.as_tuple(); }
+            friend bool operator<(const Zip_Reference& a, const value_type& b) { return a.as_tuple() < b; }
+            friend bool operator<(const value_type& a, const Zip_Reference& b) { return a < b.as_tuple(); }
+
+        private:
+            std::tuple<Ts&...> m_refs;
+
+            // assigning a tuple of references writes through the references
+            template <typename Tuple>
+            void assign(const Tuple& other) { m_refs = other; }
+
+            template <typename Tuple>
+            void assign_move(Tuple&& other) { assign_move(std::move(other), std::index_sequence_for<Ts...>()); }
+
+            template <typename Tuple, size_t... I>
+            void assign_move(Tuple&& other, std::index_sequence<I...>)
+            {
+                ((std::get<I>(m_refs) = std::move(std::get<I>(other))), ...);
+            }
+
+            template <size_t... I>
+            void swap_elements(Zip_Reference& other, std::index_sequence<I...>)
+            {
+                using std::swap;
+                (swap(std::get<I>(m_refs), std::get<I>(other.m_refs)), ...);
+            }
+    };
+
+    template <size_t I, typename... Ts>
+    auto& get(const Zip_Reference<Ts...>& ref) noexcept { return ref.template get<I>(); }
+
+    /* Random access iterator yielding a Zip_Reference for each row */
+
+    template <typename... Ts>
+    class Zip_Iterator
+    {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::tuple<std::remove_cv_t<Ts>...>;
+            using difference_type = ptrdiff_t;
+            using reference = Zip_Reference<Ts...>;
+            using pointer = void;
+
+            Zip_Iterator() noexcept : m_arrays(), m_pos(0) {}
+            Zip_Iterator(std::tuple<Ts*...> arrays_, difference_type pos_) noexcept : m_arrays(arrays_), m_pos(pos_) {}
+
+            reference operator*() const noexcept { return (*this)[0]; }
+
+            reference operator[](difference_type n) const noexcept
+            {
+                return std::apply([this, n] (Ts*... arrays) { return reference(arrays[m_pos + n]...); }, m_arrays);
+            }
+
+            Zip_Iterator& operator++() noexcept { ++m_pos; return *this; }
+            Zip_Iterator& operator--() noexcept { --m_pos; return *this; }
+            Zip_Iterator operator++(int) noexcept { Zip_Iterator tmp = *this; ++m_pos; return tmp; }
+            Zip_Iterator operator--(int) noexcept { Zip_Iterator tmp = *this; --m_pos; return tmp; }
+            Zip_Iterator& operator+=(difference_type n) noexcept { m_pos += n; return *this; }
+            Zip_Iterator& operator-=(difference_type n) noexcept { m_pos -= n; return *this; }
+
+            friend Zip_Iterator operator+(Zip_Iterator it, difference_type n) noexcept { return it += n; }
+            friend Zip_Iterator operator+(difference_type n, Zip_Iterator it) noexcept { return it += n; }
+            friend Zip_Iterator operator-(Zip_Iterator it, difference_type n) noexcept { return it -= n; }
+            friend difference_type operator-(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos - b.m_pos; }
+
+            // iterators are only comparable within the same Zip_Array_Wrapper
+            friend bool operator==(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos == b.m_pos; }
+            friend bool operator!=(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos != b.m_pos; }
+            friend bool operator<(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos < b.m_pos; }
+            friend bool operator>(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos > b.m_pos; }
+            friend bool operator<=(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos <= b.m_pos; }
+            friend bool operator>=(const Zip_Iterator& a, const Zip_Iterator& b) noexcept { return a.m_pos >= b.m_pos; }
+
+        private:
+            std::tuple<Ts*...> m_arrays;
+            difference_type m_pos;
+    };
+
+    /* The Zip_Array_Wrapper bundles several Array_Wrappers of the same size into one structure of
+       arrays. Iterating yields a Zip_Reference per row so the arrays can be sorted or permuted together
+       with the standard algorithms, while each array stays contiguous for vectorized kernels.
+
+       fill, swap and assignment work array by array and so use the same bulk kernels as Array_Wrapper.
+       Comparisons order the rows lexicographically, as if comparing a std::array of std::tuple.
+
+       Dynamic extent wrappers may be bundled as long as they are all the same size, otherwise the
+       constructor throws std::length_error. */
+
+    template <size_t N, typename... Ts>
+    class Zip_Array_Wrapper
+    {
+        public:
+            /* TYPES */
+            using value_type = std::tuple<std::remove_cv_t<Ts>...>;
+            using reference = Zip_Reference<Ts...>;
+            using const_reference = Zip_Reference<const Ts...>;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using iterator = Zip_Iterator<Ts...>;
+            using const_iterator = Zip_Iterator<const Ts...>;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+            template <size_t I>
+            using array_type = Array_Wrapper<std::tuple_element_t<I, std::tuple<Ts...>>, N>;
+
+            static constexpr size_type extent = N;
+
+            /* CONSTRUCTORS */
+            Zip_Array_Wrapper(Array_Wrapper<Ts, N>... arrays_)
+                : m_arrays(arrays_...)
+            {
+                static_assert(sizeof...(Ts) > 0);
+
+                if constexpr (N == dynamic_extent)
+                {
+                    const size_type sizes[] = {arrays_.size()...};
+                    for (size_type s : sizes)
+                    {
+                        if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(s != sizes[0])) { detail::raise_length_error(sizes[0], s); }
+                    }
+                }
+            }
+
+            // copying a wrapper copies the pointers, assigning one copies the elements
+            Zip_Array_Wrapper(const Zip_Array_Wrapper&) = default;
+
+            /* COMPARISON */
+            bool operator==(const Zip_Array_Wrapper& other) const noexcept
+            {
+                return each_pair(other, [] (const auto& a, const auto& b) { return a == b; });
+            }
+
+            bool operator!=(const Zip_Array_Wrapper& other) const noexcept { return !(*this == other); }
+
+            bool operator<(const Zip_Array_Wrapper& other) const
+            {
+                return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+            }
+
+            bool operator>(const Zip_Array_Wrapper& other) const { return other < *this; }
+            bool operator<=(const Zip_Array_Wrapper& other) const { return !(other < *this); }
+            bool operator>=(const Zip_Array_Wrapper& other) const { return !(*this < other); }
+
+            /* ASSIGNMENT */
+            // copy assignment will copy elements into the underlying arrays
+            Zip_Array_Wrapper& operator=(const Zip_Array_Wrapper& other)
+            {
+                each_pair_mutable(other, [] (auto& a, auto& b) { a = b; });
+                return *this;
+            }
+
+            void fill(const value_type& val)
+            {
+                fill_arrays(val, std::index_sequence_for<Ts...>());
+            }
+
+            // swaps the elements of every array, not the pointers
+            void swap(Zip_Array_Wrapper& other)
+            {
+                each_pair_mutable(other, [] (auto& a, auto& b) { a.swap(b); });
+            }
+
+            // sorts the rows by the elements of array I, permuting every array in a single pass
+            template <size_t I, typename Compare = std::less<>>
+            void sort_by(Compare comp = Compare())
+            {
+                std::sort(begin(), end(), [&comp] (const auto& a, const auto& b)
+                {
+                    using std::get;
+                    return comp(get<I>(a), get<I>(b));
+                });
+            }
+
+            template <size_t I, typename Compare = std::less<>>
+            void stable_sort_by(Compare comp = Compare())
+            {
+                std::stable_sort(begin(), end(), [&comp] (const auto& a, const auto& b)
+                {
+                    using std::get;
+                    return comp(get<I>(a), get<I>(b));
+                });
+            }
+
+            /* ITERATORS */
+            iterator begin() noexcept { return iterator(pointers(), 0); }
+            const_iterator begin() const noexcept { return const_iterator(const_pointers(), 0); }
+            const_iterator cbegin() const noexcept { return begin(); }
+
+            iterator end() noexcept { return iterator(pointers(), static_cast<difference_type>(size())); }
+            const_iterator end() const noexcept { return const_iterator(const_pointers(), static_cast<difference_type>(size())); }
+            const_iterator cend() const noexcept { return end(); }
+
+            reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+            const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+            reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+            const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+            /* CAPACITY */
+            constexpr size_type size() const noexcept { return std::get<0>(m_arrays).size(); }
+            constexpr size_type max_size() const noexcept { return size(); }
+            constexpr bool empty() const noexcept { return size() == 0; }
+
+            /* ELEMENT ACCESS */
+            reference operator[](size_type pos) noexcept
+            {
+                detail::check_access(pos, size());
+                return begin()[static_cast<difference_type>(pos)];
+            }
+
+            const_reference operator[](size_type pos) const noexcept
+            {
+                detail::check_access(pos, size());
+                return begin()[static_cast<difference_type>(pos)];
+            }
+
+            reference at(size_type pos)
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size())) { detail::raise_range_error(pos); }
+                return (*this)[pos];
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (FIBB_ARRAY_WRAPPER_CHECK_FAILED(pos >= size())) { detail::raise_range_error(pos); }
+                return (*this)[pos];
+            }
+
+            reference front() noexcept { return (*this)[0]; }
+            const_reference front() const noexcept { return (*this)[0]; }
+            reference back() noexcept { return (*this)[size() - 1]; }
+            const_reference back() const noexcept { return (*this)[size() - 1]; }
+
+            // the individual arrays
+            template <size_t I>
+            array_type<I>& get() noexcept { return std::get<I>(m_arrays); }
+
+            template <size_t I>
+            const array_type<I>& get() const noexcept { return std::get<I>(m_arrays); }
+
+        private:
+            std::tuple<Array_Wrapper<Ts, N>...> m_arrays;
+
+            std::tuple<Ts*...> pointers() noexcept
+            {
+                return std::apply([] (auto&... arrays) { return std::tuple<Ts*...>(arrays.data()...); }, m_arrays);
+            }
+
+            std::tuple<const Ts*...> const_pointers() const noexcept
+            {
+                return std::apply([] (const auto&... arrays) { return std::tuple<const Ts*...>(arrays.data()...); }, m_arrays);
+            }
+
+            template <typename Fn>
+            bool each_pair(const Zip_Array_Wrapper& other, Fn fn) const
+            {
+                return each_pair(other, fn, std::index_sequence_for<Ts...>());
+            }
+
+            template <typename Fn, size_t... I>
+            bool each_pair(const Zip_Array_Wrapper& other, Fn fn, std::index_sequence<I...>) const
+            {
+                return (fn(std::get<I>(m_arrays), std::get<I>(other.m_arrays)) && ...);
+            }
+
+            template <typename Other, typename Fn>
+            void each_pair_mutable(Other& other, Fn fn)
+            {
+                each_pair_mutable(other, fn, std::index_sequence_for<Ts...>());
+            }
+
+            template <typename Other, typename Fn, size_t... I>
+            void each_pair_mutable(Other& other, Fn fn, std::index_sequence<I...>)
+            {
+                (fn(std::get<I>(m_arrays), std::get<I>(other.m_arrays)), ...);
+            }
+
+            template <size_t... I>
+            void fill_arrays(const value_type& val, std::index_sequence<I...>)
+            {
+                (std::get<I>(m_arrays).fill(std::get<I>(val)), ...);
+            }
+    };
+
+    template <size_t N, typename... Ts>
+    Zip_Array_Wrapper(Ts (&... arrays_)[N]) -> Zip_Array_Wrapper<N, Ts...>;
+}
+
+#endif // FIBB_ZIP_ARRAY_WRAPPER